@@ -0,0 +1,564 @@
+// ini.c各解析入口的一致性测试：对同一组输入，逐一比较各入口与ini_parse_string_length()
+// 得到的回调序列（节、键、值）和返回值，输入覆盖续行、行内注释、BOM、超长行、
+// 错误行号、没有末尾换行的最后一行和CRLF等情形；另外在每个SIMD级别下与标量实现比较
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+extern "C" {
+#include "cmockery.h"
+}
+#include "ini.h"
+
+// 测试输入：名称 + 内容
+struct Case
+{
+    const char* name;
+    std::string text;
+};
+
+// 一行超过INI_MAX_LINE的键值
+static std::string long_line()
+{
+    return "[long]\nkey = " + std::string(INI_MAX_LINE + 50, 'x') + "\nafter = 1\n";
+}
+
+static std::vector<Case> cases()
+{
+    return {
+        {"basic", "; comment\n[section]\nname = value\nother=2\n\n[second]\nname = again\n"},
+        {"no section", "top = 1\n[s]\nk = v\n"},
+        {"continuation", "[multi]\nkey = first\n  second\n\tthird\nnext = 1\n  more\n"},
+        {"repeated key", "[r]\nk = 1\nk = 2\nk = 3\n"},
+        {"inline comment", "[c]\nk = value ; comment\nq = a;b\nz = x # not a comment\n"},
+        {"bom", "\xEF\xBB\xBF[bom]\nk = v\n"},
+        {"long line", long_line()},
+        {"errors", "[ok]\nk = v\nno equals sign\n[unclosed\nafter = 1\n"},
+        {"error first line", "garbage\n[s]\nk = v\n"},
+        {"no final newline", "[s]\nk = v\nlast = 1"},
+        {"crlf", "[s]\r\nk = v\r\n  cont\r\nq = 2\r\n"},
+        {"empty values", "[e]\nk =\nq = \n  cont\n"},
+        {"empty", ""},
+        {"continuation across sections", "[a]\nk = 1\n[b]\n  orphan\nj = 2\n\n  more\n[c]\n  again\n"},
+        {"comment after =", "[c]\nk =; c\nq = ; c\nz =\t;c\nw = x;y ; z\n"},
+        {"bom then error", "\xEF\xBB\xBFgarbage\n[s]\nk = v\n"},
+    };
+}
+
+// 把回调序列记录成一行一个条目的文本，便于整体比较
+static void record(std::string* out, const char* section, const char* name, const char* value)
+{
+    *out += section;
+    *out += '|';
+    *out += name ? name : "(null)";
+    *out += '|';
+    *out += value ? value : "(null)";
+    *out += '\n';
+}
+
+#if INI_HANDLER_LINENO
+static int record_handler(void* user, const char* section, const char* name, const char* value, int lineno)
+{
+    (void)lineno;
+#else
+static int record_handler(void* user, const char* section, const char* name, const char* value)
+{
+#endif
+    record(static_cast<std::string*>(user), section, name, value);
+    return 1;
+}
+
+// 参照结果：ini_parse_string_length()的回调序列和返回值
+static std::string reference(const std::string& text, int* error)
+{
+    std::string out;
+    *error = ini_parse_string_length(text.data(), text.size(), record_handler, &out);
+    return out;
+}
+
+// ini_handler_ex的记录：按长度还原出与record_handler相同的文本，
+// 并检查offset确实是第lineno行的行首
+struct Recorder
+{
+    explicit Recorder(const std::string& text) : starts(1, 0)
+    {
+        for (size_t i = 0; i < text.size(); i++)
+            if (text[i] == '\n')
+                starts.push_back(i + 1);
+    }
+
+    std::vector<size_t> starts;  // 每行行首的偏移
+    std::string out;
+};
+
+static int record_handler_ex(void* user, const ini_entry* entry)
+{
+    Recorder* recorder = static_cast<Recorder*>(user);
+    std::string section(entry->section, entry->section_len);
+    std::string name = entry->name ? std::string(entry->name, entry->name_len) : "(null)";
+    std::string value = entry->value ? std::string(entry->value, entry->value_len) : "(null)";
+    record(&recorder->out, section.c_str(), name.c_str(), value.c_str());
+    assert_in_range(entry->lineno, 1, recorder->starts.size());
+    assert_int_equal(entry->offset, recorder->starts[entry->lineno - 1]);
+    return 1;
+}
+
+static const char* kTempFile = "test_ini_parse.tmp";
+
+static void write_file(const std::string& text)
+{
+    FILE* file = fopen(kTempFile, "wb");
+    assert_true(file != NULL);
+    assert_int_equal(fwrite(text.data(), 1, text.size(), file), text.size());
+    fclose(file);
+}
+
+// 由注释行组成、恰好size字节的填充
+static std::string padding(size_t size)
+{
+    std::string text;
+    while (size - text.size() > 80)
+        text += ";" + std::string(78, '-') + "\n";
+    if (text.size() < size)
+        text += ";" + std::string(size - text.size() - 1, '-');
+    if (!text.empty())
+        text.back() = '\n';
+    return text;
+}
+
+// INI_CALL_HANDLER_ON_NEW_SECTION时新节本身也有一次回调
+static std::string new_section(const std::string& section)
+{
+    return INI_CALL_HANDLER_ON_NEW_SECTION ? section + "|(null)|(null)\n" : "";
+}
+
+// 改动之前的解析器（默认编译选项）对每个用例的回调序列和返回值，
+// 防止参照ini_parse_string_length()本身的行为悄悄改变
+struct Golden
+{
+    const char* name;
+    int error;
+    std::string out;
+};
+
+static std::vector<Golden> golden()
+{
+    return {
+        {"basic", 0, "section|name|value\nsection|other|2\nsecond|name|again\n"},
+        {"no section", 0, "|top|1\ns|k|v\n"},
+        {"continuation", 0, "multi|key|first\nmulti|key|second\nmulti|key|third\nmulti|next|1\nmulti|next|more\n"},
+        {"repeated key", 0, "r|k|1\nr|k|2\nr|k|3\n"},
+        {"inline comment", 0, "c|k|value\nc|q|a;b\nc|z|x # not a comment\n"},
+        {"bom", 0, "bom|k|v\n"},
+        // 超长的行截断在INI_MAX_LINE - 1个字符，余下部分丢弃并记为该行出错
+        {"long line", 2, "long|key|" + std::string(INI_MAX_LINE - 7, 'x') + "\nlong|after|1\n"},
+        {"errors", 3, "ok|k|v\nok|after|1\n"},
+        {"error first line", 1, "s|k|v\n"},
+        {"no final newline", 0, "s|k|v\ns|last|1\n"},
+        {"crlf", 0, "s|k|v\ns|k|cont\ns|q|2\n"},
+        {"empty values", 0, "e|k|\ne|q|\ne|q|cont\n"},
+        {"empty", 0, ""},
+        // 节行之后没有可接续的键，续行记为出错；空行不打断续行
+        {"continuation across sections", 4, "a|k|1\nb|j|2\nb|j|more\n"},
+        // 紧跟在"="之后的";"属于值，"="后有空白时才是注释
+        {"comment after =", 0, "c|k|; c\nc|q|\nc|z|\nc|w|x;y\n"},
+        {"bom then error", 1, "s|k|v\n"},
+    };
+}
+
+static void test_golden(void** state)
+{
+    (void)state;
+#if INI_ALLOW_MULTILINE && INI_ALLOW_BOM && INI_ALLOW_INLINE_COMMENTS && !INI_ALLOW_NO_VALUE && \
+    !INI_STOP_ON_FIRST_ERROR && !INI_CALL_HANDLER_ON_NEW_SECTION && INI_MAX_LINE == 200
+    std::vector<Golden> expected = golden();
+    std::vector<Case> all = cases();
+    assert_int_equal(all.size(), expected.size());
+    for (size_t i = 0; i < all.size(); i++)
+    {
+        assert_string_equal(all[i].name, expected[i].name);
+        int error;
+        assert_string_equal(reference(all[i].text, &error).c_str(), expected[i].out.c_str());
+        assert_int_equal(error, expected[i].error);
+    }
+#endif
+}
+
+// 参照本身的几个已知结果：续行拼接、行内注释、BOM和错误行号，随编译选项而不同
+static void test_reference(void** state)
+{
+    (void)state;
+    int error;
+    std::string expected = new_section("m") + "m|k|a\n" + (INI_ALLOW_MULTILINE ? "m|k|b\n" : "");
+    assert_string_equal(reference("[m]\nk = a\n  b\n", &error).c_str(), expected.c_str());
+    assert_int_equal(error, INI_ALLOW_MULTILINE ? 0 : 3);
+    expected = new_section("c") + (INI_ALLOW_INLINE_COMMENTS ? "c|k|v\n" : "c|k|v ; note\n");
+    assert_string_equal(reference("[c]\nk = v ; note\n", &error).c_str(), expected.c_str());
+    expected = INI_ALLOW_BOM ? new_section("b") + "b|k|v\n" : "|k|v\n";
+    assert_string_equal(reference("\xEF\xBB\xBF[b]\nk = v\n", &error).c_str(), expected.c_str());
+    assert_int_equal(error, INI_ALLOW_BOM ? 0 : 1);
+    reference("[ok]\nk = v\nno equals sign\n[unclosed\n", &error);
+    assert_int_equal(error, INI_ALLOW_NO_VALUE ? 4 : 3);
+}
+
+// ini_parse_mmap()映射整个文件解析，结果与按字符串解析相同；文件不存在时返回-1
+static void test_mmap(void** state)
+{
+    (void)state;
+    for (const Case& c : cases())
+    {
+        int expected_error;
+        std::string expected = reference(c.text, &expected_error);
+        write_file(c.text);
+        std::string got;
+        int error = ini_parse_mmap(kTempFile, record_handler, &got);
+        assert_string_equal(got.c_str(), expected.c_str());
+        assert_int_equal(error, expected_error);
+    }
+    remove(kTempFile);
+    std::string got;
+    assert_int_equal(ini_parse_mmap("test_ini_parse.missing", record_handler, &got), -1);
+}
+
+// 各*_ex入口给出与ini_handler相同的回调序列，字符串按长度传入，不以NUL结尾
+static void test_ex(void** state)
+{
+    (void)state;
+    for (const Case& c : cases())
+    {
+        int expected_error;
+        std::string expected = reference(c.text, &expected_error);
+        Recorder length(c.text);
+        assert_int_equal(ini_parse_string_length_ex(c.text.data(), c.text.size(), record_handler_ex, &length),
+                         expected_error);
+        assert_string_equal(length.out.c_str(), expected.c_str());
+
+        Recorder terminated(c.text);
+        assert_int_equal(ini_parse_string_ex(c.text.c_str(), record_handler_ex, &terminated), expected_error);
+        assert_string_equal(terminated.out.c_str(), expected.c_str());
+
+        write_file(c.text);
+        Recorder file(c.text);
+        assert_int_equal(ini_parse_ex(kTempFile, record_handler_ex, &file), expected_error);
+        assert_string_equal(file.out.c_str(), expected.c_str());
+
+        Recorder stream(c.text);
+        FILE* opened = fopen(kTempFile, "rb");
+        assert_true(opened != NULL);
+        assert_int_equal(ini_parse_file_ex(opened, record_handler_ex, &stream), expected_error);
+        fclose(opened);
+        assert_string_equal(stream.out.c_str(), expected.c_str());
+
+        Recorder mapped(c.text);
+        assert_int_equal(ini_parse_mmap_ex(kTempFile, record_handler_ex, &mapped), expected_error);
+        assert_string_equal(mapped.out.c_str(), expected.c_str());
+    }
+    remove(kTempFile);
+}
+
+// 按长度解析时，length之后的字节不能被读到
+static void test_ex_length(void** state)
+{
+    (void)state;
+    std::string text = "[s]\nk = v\nq = 1";
+    int expected_error;
+    std::string expected = reference(text, &expected_error);
+    std::string padded = text + "2\nextra = 1\n";
+    Recorder recorder(padded);
+    assert_int_equal(ini_parse_string_length_ex(padded.data(), text.size(), record_handler_ex, &recorder),
+                     expected_error);
+    assert_string_equal(recorder.out.c_str(), expected.c_str());
+}
+
+// ini_parse_file()按64KiB块fread，用填充把每个用例的各个位置依次挪到块边界上
+static void test_file_blocks(void** state)
+{
+    (void)state;
+    const size_t block = 65536;
+    for (const Case& c : cases())
+    {
+        size_t step = c.text.size() / 32 + 1;
+        for (size_t shift = 0; shift <= c.text.size(); shift += step)
+        {
+            std::string text = padding(block - shift) + c.text + padding(block) + c.text;
+            int expected_error;
+            std::string expected = reference(text, &expected_error);
+
+            FILE* file = tmpfile();
+            assert_true(file != NULL);
+            assert_int_equal(fwrite(text.data(), 1, text.size(), file), text.size());
+            rewind(file);
+            std::string got;
+            assert_int_equal(ini_parse_file(file, record_handler, &got), expected_error);
+            fclose(file);
+            assert_string_equal(got.c_str(), expected.c_str());
+        }
+    }
+}
+
+// ini_parse_string_inplace()在缓冲区上就地写NUL，但不能越过length写到后面的字节
+static void test_inplace(void** state)
+{
+    (void)state;
+    for (const Case& c : cases())
+    {
+        int expected_error;
+        std::string expected = reference(c.text, &expected_error);
+        std::vector<char> buffer(c.text.begin(), c.text.end());
+        buffer.push_back('#');
+        std::string got;
+        assert_int_equal(ini_parse_string_inplace(buffer.data(), c.text.size(), record_handler, &got),
+                         expected_error);
+        assert_string_equal(got.c_str(), expected.c_str());
+        assert_int_equal(buffer.back(), '#');
+    }
+}
+
+// ini_parse_parallel()用的输入：超过两个分块，节行、续行、错误行散布在各个分块中
+static std::string large_input()
+{
+    std::string text;
+    for (int block = 0; text.size() < 3 * 1024 * 1024; block++)
+    {
+        text += "[block" + std::to_string(block) + "]\nindex = " + std::to_string(block) + "\n";
+        text += padding(block * 97 % 4000);
+        for (const Case& c : cases())
+            text += c.text + "\n";
+    }
+    return text;
+}
+
+static void test_parallel(void** state)
+{
+    (void)state;
+    std::string text = large_input();
+    int expected_error;
+    std::string expected = reference(text, &expected_error);
+    for (int threads : {1, 2, 4, 0})
+    {
+        std::vector<char> buffer(text.begin(), text.end());
+        std::string got;
+        assert_int_equal(ini_parse_parallel(buffer.data(), buffer.size(), threads, record_handler, &got),
+                         expected_error);
+        assert_true(got == expected);
+
+        Recorder recorder(text);
+        assert_int_equal(ini_parse_parallel_ex(text.data(), text.size(), threads, record_handler_ex, &recorder),
+                         expected_error);
+        assert_true(recorder.out == expected);
+    }
+
+    // 小输入退化为串行解析
+    for (const Case& c : cases())
+    {
+        std::string small = reference(c.text, &expected_error);
+        Recorder recorder(c.text);
+        assert_int_equal(ini_parse_parallel_ex(c.text.data(), c.text.size(), 4, record_handler_ex, &recorder),
+                         expected_error);
+        assert_string_equal(recorder.out.c_str(), small.c_str());
+    }
+}
+
+// 按给定的切分点把text分多次喂入推送式解析器，返回ini_parser_finish()的结果
+static int push(const std::string& text, const std::vector<size_t>& cuts, bool ex, std::string* out)
+{
+    ini_parser parser;
+    Recorder recorder(text);
+    if (ex)
+        ini_parser_init_ex(&parser, record_handler_ex, &recorder);
+    else
+        ini_parser_init(&parser, record_handler, out);
+    size_t begin = 0;
+    for (size_t cut : cuts)
+    {
+        ini_parser_feed(&parser, text.data() + begin, cut - begin);
+        begin = cut;
+    }
+    ini_parser_feed(&parser, text.data() + begin, text.size() - begin);
+    int error = ini_parser_finish(&parser);
+    if (ex)
+        *out = recorder.out;
+    return error;
+}
+
+// 每个切分点各切一刀
+static void test_push_split(void** state)
+{
+    (void)state;
+    for (const Case& c : cases())
+    {
+        int expected_error;
+        std::string expected = reference(c.text, &expected_error);
+        for (size_t cut = 0; cut <= c.text.size(); cut++)
+        {
+            for (bool ex : {false, true})
+            {
+                std::string got;
+                assert_int_equal(push(c.text, {cut}, ex, &got), expected_error);
+                assert_string_equal(got.c_str(), expected.c_str());
+            }
+        }
+    }
+}
+
+// 逐字节喂入，以及随机大小的分块
+static void test_push_chunks(void** state)
+{
+    (void)state;
+    srand(1);
+    for (const Case& c : cases())
+    {
+        int expected_error;
+        std::string expected = reference(c.text, &expected_error);
+        std::vector<size_t> bytes;
+        for (size_t cut = 1; cut < c.text.size(); cut++)
+            bytes.push_back(cut);
+        for (int round = 0; round < 50; round++)
+        {
+            std::vector<size_t> cuts = round == 0 ? bytes : std::vector<size_t>();
+            for (size_t cut = rand() % 8; round > 0 && cut < c.text.size(); cut += rand() % 24)
+                cuts.push_back(cut);
+            for (bool ex : {false, true})
+            {
+                std::string got;
+                assert_int_equal(push(c.text, cuts, ex, &got), expected_error);
+                assert_string_equal(got.c_str(), expected.c_str());
+            }
+        }
+    }
+
+    // 大输入按4KiB喂入
+    std::string text = large_input();
+    int expected_error;
+    std::string expected = reference(text, &expected_error);
+    std::vector<size_t> cuts;
+    for (size_t cut = 4096; cut < text.size(); cut += 4096)
+        cuts.push_back(cut);
+    for (bool ex : {false, true})
+    {
+        std::string got;
+        assert_int_equal(push(text, cuts, ex, &got), expected_error);
+        assert_true(got == expected);
+    }
+}
+
+// len字节的空白，混有isspace()认作空白的各个字符
+static std::string blanks(size_t len)
+{
+    static const char kBlanks[] = " \t \v \f \r ";
+    std::string text;
+    for (size_t i = 0; i < len; i++)
+        text += kBlanks[i % (sizeof(kBlanks) - 1)];
+    return text;
+}
+
+// 在16/32字节边界附近的行，用于比较各SIMD级别：值、注释、节名、续行和
+// 行内注释分别恰好占len字节，空白游程跨越边界
+static std::string boundary_lines(size_t len)
+{
+    std::string text = "[" + std::string(len - 2, 's') + "]\n";
+    text += ";" + std::string(len - 1, 'c') + "\n";
+    text += "k = " + std::string(len - 4, 'v') + "\n";
+    text += "  " + std::string(len - 2, 'm') + "\n";
+    text += "i = " + std::string(len > 8 ? len - 8 : 1, 'v') + " ; c\n";
+    text += "w" + blanks(len - 2) + "=" + blanks(len) + "x" + blanks(len) + "\n";
+    text += blanks(len) + "l = " + blanks(len) + "y\n";
+    text += "e" + blanks(len - 1) + "\n";
+    text += std::string(len, 'n') + "\n";
+    return text;
+}
+
+static std::vector<Case> simd_cases()
+{
+    std::vector<Case> all = cases();
+    std::string value;
+    for (int i = 0; i < 200; i++)
+        value += "word" + std::to_string(i) + (i % 7 ? " " : " \t ");
+    all.push_back({"long value", "[v]\nk = " + value + "; tail\nq = " + value + "\n  " + value + "\n"});
+    static const struct { size_t len; const char* name; const char* unterminated; } lines[] = {
+        {15, "15-byte lines", "15-byte lines, no final newline"},
+        {16, "16-byte lines", "16-byte lines, no final newline"},
+        {17, "17-byte lines", "17-byte lines, no final newline"},
+        {31, "31-byte lines", "31-byte lines, no final newline"},
+        {32, "32-byte lines", "32-byte lines, no final newline"},
+        {33, "33-byte lines", "33-byte lines, no final newline"},
+    };
+    for (const auto& l : lines)
+    {
+        all.push_back({l.name, boundary_lines(l.len)});
+        all.push_back({l.unterminated, boundary_lines(l.len) + std::string(l.len, 'z')});
+    }
+    return all;
+}
+
+// 连同行号一起记录
+static int record_handler_lineno(void* user, const ini_entry* entry)
+{
+    std::string* out = static_cast<std::string*>(user);
+    std::string section(entry->section, entry->section_len);
+    std::string name = entry->name ? std::string(entry->name, entry->name_len) : "(null)";
+    std::string value = entry->value ? std::string(entry->value, entry->value_len) : "(null)";
+    record(out, section.c_str(), name.c_str(), value.c_str());
+    *out += std::to_string(entry->lineno) + "\n";
+    return 1;
+}
+
+// 标量实现作参照，每个支持的SIMD级别的回调序列、行号和错误行号都必须与之一致；
+// 每个用例前再加0~32字节，让各行落在不同的对齐位置上
+static void test_simd_levels(void** state)
+{
+    (void)state;
+    int saved = ini_simd_level();
+    int top = ini_set_simd_level(INI_SIMD_AVX2);
+    for (const Case& c : simd_cases())
+    {
+        for (size_t shift = 0; shift <= 32; shift++)
+        {
+            std::string text = padding(shift) + c.text;
+            assert_int_equal(ini_set_simd_level(INI_SIMD_SCALAR), INI_SIMD_SCALAR);
+            std::string expected;
+            int expected_error = ini_parse_string_length_ex(text.data(), text.size(), record_handler_lineno,
+                                                            &expected);
+            std::string expected_plain;
+            assert_int_equal(ini_parse_string_length(text.data(), text.size(), record_handler, &expected_plain),
+                             expected_error);
+            for (int level = INI_SIMD_SCALAR; level <= top; level++)
+            {
+                assert_int_equal(ini_set_simd_level(level), level);
+                // 用恰好等长的堆缓冲区，越过末尾的读取能被ASan发现
+                std::vector<char> buffer(text.begin(), text.end());
+                std::string got;
+                assert_int_equal(ini_parse_string_length_ex(buffer.data(), buffer.size(), record_handler_lineno,
+                                                            &got), expected_error);
+                assert_string_equal(got.c_str(), expected.c_str());
+                std::string plain;
+                assert_int_equal(ini_parse_string_length(buffer.data(), buffer.size(), record_handler, &plain),
+                                 expected_error);
+                assert_string_equal(plain.c_str(), expected_plain.c_str());
+            }
+        }
+    }
+    ini_set_simd_level(saved);
+}
+
+int main(int argc, char* argv[])
+{
+    (void)argc;
+    (void)argv;
+    const UnitTest tests[] =
+    {
+        unit_test(test_golden),
+        unit_test(test_reference),
+        unit_test(test_mmap),
+        unit_test(test_ex),
+        unit_test(test_ex_length),
+        unit_test(test_file_blocks),
+        unit_test(test_inplace),
+        unit_test(test_parallel),
+        unit_test(test_push_split),
+        unit_test(test_push_chunks),
+        unit_test(test_simd_levels),
+    };
+    return run_tests(tests);
+}
@@ -67,3 +67,13 @@ target("test_function_type")
     add_ldflags("-fPIC") 
     add_deps("cmockery")  
     add_links("cmockery") 
+
+target("test_ini_parse")
+    set_kind("binary")
+    add_files("test_ini_parse.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("cmockery", "ini")  
+    add_links("cmockery", "ini") 
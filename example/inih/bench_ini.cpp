@@ -0,0 +1,368 @@
+// inih benchmark: parse throughput of ini_parse, ini_parse_file,
+// ini_parse_string_length and INIReader construction over synthetic INI data.
+//
+// Usage: bench_ini [options]
+//   --sizes=1K,64K,1M,16M   data sizes to generate (suffixes K, M, G)
+//   --line-length=N         average value length in bytes (default 24)
+//   --comments=F            fraction of full-line comments, 0..1 (default 0.1)
+//   --inline-comments=F     fraction of values with an inline comment (default 0.2)
+//   --multiline=F           fraction of values with a continuation line (default 0.05)
+//   --sections=N            number of sections (default 100)
+//   --rounds=N              runs per measurement, the best one is reported (default 5)
+//   --cache=warm,cold       page-cache states to measure the file-based APIs in
+//   --dir=PATH              where to write the generated file (default /tmp)
+//   --seed=N                generator seed (default 1)
+//   --json                  print results as JSON instead of a table
+//
+// "cold" runs drop the file from the page cache before every run (with
+// posix_fadvise, which needs no privileges), so they include the disk read.
+// In-memory parsing (ini_parse_string_length) is only measured warm.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "ini.h"
+#include "INIReader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define BENCH_HAVE_FADVISE 1
+#else
+#define BENCH_HAVE_FADVISE 0
+#endif
+
+struct Options
+{
+    std::vector<uint64_t> sizes = {1ull << 10, 64ull << 10, 1ull << 20, 16ull << 20};
+    int line_length = 24;
+    double comments = 0.1;
+    double inline_comments = 0.2;
+    double multiline = 0.05;
+    int sections = 100;
+    int rounds = 5;
+    bool warm = true;
+    bool cold = false;
+    std::string dir = "/tmp";
+    uint64_t seed = 1;
+    bool json = false;
+};
+
+struct Result
+{
+    uint64_t size;
+    uint64_t lines;
+    const char* api;
+    const char* cache;
+    double seconds;
+    int error;
+};
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t parse_size(const char* s)
+{
+    char* end;
+    double n = strtod(s, &end);
+    switch (*end)
+    {
+    case 'k': case 'K': n *= 1024; break;
+    case 'm': case 'M': n *= 1024 * 1024; break;
+    case 'g': case 'G': n *= 1024.0 * 1024 * 1024; break;
+    default: break;
+    }
+    return static_cast<uint64_t>(n);
+}
+
+// xorshift64*, so the same seed always generates the same file
+class Random
+{
+public:
+    explicit Random(uint64_t seed) : _state(seed ? seed : 1) {}
+
+    uint64_t next()
+    {
+        _state ^= _state >> 12;
+        _state ^= _state << 25;
+        _state ^= _state >> 27;
+        return _state * 0x2545f4914f6cdd1dULL;
+    }
+
+    bool chance(double p) { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0) < p; }
+    int range(int lo, int hi) { return lo + static_cast<int>(next() % static_cast<uint64_t>(hi - lo + 1)); }
+
+private:
+    uint64_t _state;
+};
+
+static void append_text(std::string& out, Random& rng, int length)
+{
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789_-./";
+    for (int i = 0; i < length; i++)
+        out += alphabet[rng.next() % (sizeof(alphabet) - 1)];
+}
+
+// Generate about size bytes of INI text; lines are kept below INI_MAX_LINE
+// so that the data parses without errors in every configuration
+static std::string generate(const Options& opt, uint64_t size, uint64_t* lines)
+{
+    Random rng(opt.seed);
+    std::string out;
+    out.reserve(size + INI_MAX_LINE);
+    int max_value = INI_MAX_LINE - 40;
+    int line_length = opt.line_length < max_value ? opt.line_length : max_value;
+    uint64_t est_lines = size / static_cast<uint64_t>(line_length + 16) + 1;
+    uint64_t per_section = est_lines / static_cast<uint64_t>(opt.sections > 0 ? opt.sections : 1) + 1;
+    uint64_t key = 0;
+    int section = 0;
+
+    *lines = 0;
+    while (out.size() < size)
+    {
+        if (key % per_section == 0)
+        {
+            out += "[section";
+            out += std::to_string(section++);
+            out += "]\n";
+            ++*lines;
+        }
+        if (rng.chance(opt.comments))
+        {
+            out += "; ";
+            append_text(out, rng, rng.range(line_length / 2, line_length));
+            out += '\n';
+            ++*lines;
+            continue;
+        }
+
+        out += "key";
+        out += std::to_string(key++);
+        out += " = ";
+        append_text(out, rng, rng.range(line_length / 2 + 1, line_length * 3 / 2 < max_value ? line_length * 3 / 2 : max_value));
+        if (INI_ALLOW_INLINE_COMMENTS && rng.chance(opt.inline_comments))
+            out += "  ; note";
+        out += '\n';
+        ++*lines;
+        if (INI_ALLOW_MULTILINE && rng.chance(opt.multiline))
+        {
+            out += "    ";
+            append_text(out, rng, rng.range(line_length / 2 + 1, line_length));
+            out += '\n';
+            ++*lines;
+        }
+    }
+    return out;
+}
+
+static int counter(void* user, const char* section, const char* name, const char* value
+#if INI_HANDLER_LINENO
+                   , int lineno
+#endif
+                   )
+{
+    (void)section;
+    (void)name;
+    (void)value;
+#if INI_HANDLER_LINENO
+    (void)lineno;
+#endif
+    ++*static_cast<uint64_t*>(user);
+    return 1;
+}
+
+static void drop_cache(const std::string& path)
+{
+#if BENCH_HAVE_FADVISE && defined(POSIX_FADV_DONTNEED)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+enum Api { API_INI_PARSE, API_INI_PARSE_FILE, API_INI_PARSE_STRING_LENGTH, API_INIREADER };
+static const char* api_names[] = {"ini_parse", "ini_parse_file", "ini_parse_string_length", "INIReader"};
+
+static Result measure(const Options& opt, Api api, bool cold, const std::string& path,
+                      const std::string& data, uint64_t lines)
+{
+    Result r = {data.size(), lines, api_names[api], cold ? "cold" : "warm", 1e30, 0};
+
+    for (int round = 0; round < opt.rounds; round++)
+    {
+        if (cold)
+            drop_cache(path);
+        uint64_t entries = 0;
+        double t0 = now_sec();
+        switch (api)
+        {
+        case API_INI_PARSE:
+            r.error = ini_parse(path.c_str(), counter, &entries);
+            break;
+        case API_INI_PARSE_FILE:
+        {
+            FILE* file = fopen(path.c_str(), "rb");
+            r.error = file ? ini_parse_file(file, counter, &entries) : -1;
+            if (file)
+                fclose(file);
+            break;
+        }
+        case API_INI_PARSE_STRING_LENGTH:
+            r.error = ini_parse_string_length(data.data(), data.size(), counter, &entries);
+            break;
+        case API_INIREADER:
+        {
+            INIReader reader(path);
+            r.error = reader.ParseError();
+            break;
+        }
+        }
+        double t = now_sec() - t0;
+        if (t < r.seconds)
+            r.seconds = t;
+    }
+    return r;
+}
+
+static bool write_file(const std::string& path, const std::string& data)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+#if BENCH_HAVE_FADVISE
+    ok = fflush(file) == 0 && fsync(fileno(file)) == 0 && ok;  // Clean pages can be dropped
+#endif
+    return fclose(file) == 0 && ok;
+}
+
+static void print_json(const Options& opt, const std::vector<Result>& results)
+{
+    printf("{\n  \"config\": {\"line_length\": %d, \"comments\": %g, \"inline_comments\": %g, "
+           "\"multiline\": %g, \"sections\": %d, \"rounds\": %d, \"seed\": %llu, "
+           "\"ini_max_line\": %d, \"simd_level\": %d},\n  \"results\": [\n",
+           opt.line_length, opt.comments, opt.inline_comments, opt.multiline, opt.sections,
+           opt.rounds, static_cast<unsigned long long>(opt.seed), INI_MAX_LINE, ini_simd_level());
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& r = results[i];
+        printf("    {\"size\": %llu, \"lines\": %llu, \"api\": \"%s\", \"cache\": \"%s\", "
+               "\"seconds\": %.9f, \"mb_per_s\": %.3f, \"lines_per_s\": %.1f, \"error\": %d}%s\n",
+               static_cast<unsigned long long>(r.size), static_cast<unsigned long long>(r.lines),
+               r.api, r.cache, r.seconds, static_cast<double>(r.size) / r.seconds / (1024.0 * 1024.0),
+               static_cast<double>(r.lines) / r.seconds, r.error, i + 1 < results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+static void print_table(const std::vector<Result>& results)
+{
+    printf("%12s %10s  %-24s %-5s %11s %14s %6s\n",
+           "bytes", "lines", "api", "cache", "MB/s", "lines/s", "error");
+    for (const Result& r : results)
+    {
+        printf("%12llu %10llu  %-24s %-5s %11.1f %14.0f %6d\n",
+               static_cast<unsigned long long>(r.size), static_cast<unsigned long long>(r.lines),
+               r.api, r.cache, static_cast<double>(r.size) / r.seconds / (1024.0 * 1024.0),
+               static_cast<double>(r.lines) / r.seconds, r.error);
+    }
+}
+
+static bool parse_args(int argc, char* argv[], Options& opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        const char* eq = strchr(arg, '=');
+        std::string name(arg, eq ? static_cast<size_t>(eq - arg) : strlen(arg));
+        const char* value = eq ? eq + 1 : "";
+
+        if (name == "--sizes")
+        {
+            opt.sizes.clear();
+            for (const char* p = value; *p; )
+            {
+                opt.sizes.push_back(parse_size(p));
+                const char* comma = strchr(p, ',');
+                p = comma ? comma + 1 : p + strlen(p);
+            }
+        }
+        else if (name == "--line-length")
+            opt.line_length = atoi(value) > 1 ? atoi(value) : 2;
+        else if (name == "--comments")
+            opt.comments = atof(value);
+        else if (name == "--inline-comments")
+            opt.inline_comments = atof(value);
+        else if (name == "--multiline")
+            opt.multiline = atof(value);
+        else if (name == "--sections")
+            opt.sections = atoi(value);
+        else if (name == "--rounds")
+            opt.rounds = atoi(value) > 0 ? atoi(value) : 1;
+        else if (name == "--cache")
+        {
+            opt.warm = strstr(value, "warm") != NULL;
+            opt.cold = strstr(value, "cold") != NULL;
+        }
+        else if (name == "--dir")
+            opt.dir = value;
+        else if (name == "--seed")
+            opt.seed = strtoull(value, NULL, 10);
+        else if (name == "--json")
+            opt.json = true;
+        else
+        {
+            fprintf(stderr, "bench_ini: unknown option %s\n", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    Options opt;
+    if (!parse_args(argc, argv, opt))
+        return 1;
+
+    std::string path = opt.dir + "/bench_ini.ini";
+    std::vector<Result> results;
+    for (uint64_t size : opt.sizes)
+    {
+        uint64_t lines;
+        std::string data = generate(opt, size, &lines);
+        if (!write_file(path, data))
+        {
+            fprintf(stderr, "bench_ini: can't write %s\n", path.c_str());
+            return 1;
+        }
+        for (int api = API_INI_PARSE; api <= API_INIREADER; api++)
+        {
+            bool file_based = api != API_INI_PARSE_STRING_LENGTH;
+            if (opt.warm || !file_based)
+                results.push_back(measure(opt, static_cast<Api>(api), false, path, data, lines));
+            if (opt.cold && file_based)
+                results.push_back(measure(opt, static_cast<Api>(api), true, path, data, lines));
+        }
+        if (!opt.json)
+            fprintf(stderr, "bench_ini: %llu bytes done\n", static_cast<unsigned long long>(size));
+    }
+    remove(path.c_str());
+
+    if (opt.json)
+        print_json(opt, results);
+    else
+        print_table(results);
+    return 0;
+}
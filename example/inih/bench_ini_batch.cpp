@@ -0,0 +1,125 @@
+// INIReader benchmark: a startup batch of typed reads, as one GetMany()
+// call against the equivalent loop of GetView/GetInteger64/GetReal/
+// GetBoolean calls, at several config sizes.
+//
+// Usage: bench_ini_batch [key_counts] [batch]
+//   key_counts  comma-separated (default 1000,100000,1000000)
+//   batch       keys read per batch (default 400), one in ten missing
+//
+// Each measurement reads from a freshly built reader, after evicting the
+// CPU caches, so that every read is a first read of a cold key.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "INIReader.h"
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keys cycle through string, integer, real and boolean values
+static std::string make_ini(size_t keys)
+{
+    std::string text;
+    for (size_t i = 0; i < keys; i++)
+    {
+        if (i % 100 == 0)
+            text += "[section" + std::to_string(i / 100) + "]\n";
+        text += "key" + std::to_string(i) + " = ";
+        switch (i % 4)
+        {
+        case 0: text += "host" + std::to_string(i) + ".example.com"; break;
+        case 1: text += std::to_string(i * 7); break;
+        case 2: text += std::to_string(i) + ".25"; break;
+        default: text += i % 8 == 3 ? "true" : "off"; break;
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+static void evict_caches()
+{
+    static std::vector<char> junk(64 << 20);
+    for (size_t i = 0; i < junk.size(); i += 64)
+        junk[i]++;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<size_t> counts = {1000, 100000, 1000000};
+    if (argc > 1)
+    {
+        counts.clear();
+        for (char* p = argv[1]; *p; )
+        {
+            counts.push_back(static_cast<size_t>(strtoul(p, &p, 10)));
+            if (*p == ',')
+                p++;
+        }
+    }
+    size_t batch = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 400;
+
+    printf("Usage: bench_ini_batch [key_counts] [batch]\n");
+    printf("%10s %8s %14s %14s\n", "keys", "batch", "Get* loop", "GetMany");
+    for (size_t keys : counts)
+    {
+        std::string text = make_ini(keys);
+        std::mt19937_64 rng(1);
+        std::vector<std::string> sections(batch), names(batch);
+        std::vector<INIReader::KeyRequest> requests(batch);
+        for (size_t i = 0; i < batch; i++)
+        {
+            size_t key = rng() % keys;
+            sections[i] = "section" + std::to_string(key / 100);
+            names[i] = (i % 10 == 9 ? "missing" : "key") + std::to_string(key);
+            INIReader::KeyRequest::Type types[] = {INIReader::KeyRequest::kString, INIReader::KeyRequest::kInteger,
+                                                   INIReader::KeyRequest::kReal, INIReader::KeyRequest::kBoolean};
+            requests[i] = INIReader::KeyRequest{sections[i], names[i], types[key % 4]};
+        }
+
+        double best_loop = 1e30, best_many = 1e30;
+        double sink = 0;
+        for (int round = 0; round < 5; round++)
+        {
+            {
+                INIReader reader(text.data(), text.size());
+                evict_caches();
+                double t0 = now_sec();
+                for (const INIReader::KeyRequest& r : requests)
+                {
+                    switch (r.type)
+                    {
+                    case INIReader::KeyRequest::kString: sink += static_cast<double>(reader.GetView(r.section, r.name, "").size()); break;
+                    case INIReader::KeyRequest::kInteger: sink += static_cast<double>(reader.GetInteger64(r.section, r.name, 0)); break;
+                    case INIReader::KeyRequest::kReal: sink += reader.GetReal(r.section, r.name, 0); break;
+                    default: sink += reader.GetBoolean(r.section, r.name, false); break;
+                    }
+                }
+                double t1 = now_sec();
+                best_loop = t1 - t0 < best_loop ? t1 - t0 : best_loop;
+            }
+            {
+                INIReader reader(text.data(), text.size());
+                std::vector<INIReader::Result> results(batch, INIReader::Result{false, "", 0, 0, 0, false});
+                evict_caches();
+                double t0 = now_sec();
+                reader.GetMany(requests.data(), results.data(), batch);
+                double t1 = now_sec();
+                for (const INIReader::Result& r : results)
+                    sink += static_cast<double>(r.string.size() + r.integer) + r.real + r.boolean;
+                best_many = t1 - t0 < best_many ? t1 - t0 : best_many;
+            }
+        }
+        if (sink == 1)
+            printf(" ");  // Keep the reads from being optimized away
+
+        printf("%10zu %8zu %11.1f us %11.1f us\n", keys, batch, best_loop * 1e6, best_many * 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+// INILayeredReader benchmark: reading keys from four layers of config
+// (defaults, site, host, override) by falling through four INIReaders,
+// against one lookup in an INILayeredReader built from the same text.
+//
+// Usage: bench_ini_layered [keys] [lookups]
+//   keys     keys in the defaults layer (default 100000); each higher
+//            layer overrides a smaller share of them
+//   lookups  random reads timed (default 1000000), one in ten missing
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "INILayeredReader.h"
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Layer n sets every 4^n-th key
+static std::string make_layer(size_t keys, int layer)
+{
+    size_t step = static_cast<size_t>(1) << (2 * layer);
+    std::string text;
+    for (size_t i = 0; i < keys; i += step)
+    {
+        if (i % 100 == 0 || step > 100)
+            text += "[section" + std::to_string(i / 100) + "]\n";
+        text += "key" + std::to_string(i) + " = layer" + std::to_string(layer) + " " + std::to_string(i) + "\n";
+    }
+    return text;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t keys = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 100000;
+    size_t lookups = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 1000000;
+
+    std::vector<std::string> texts;
+    for (int layer = 0; layer < 4; layer++)
+        texts.push_back(make_layer(keys, layer));
+
+    std::mt19937_64 rng(1);
+    std::vector<std::string> sections(lookups), names(lookups);
+    for (size_t i = 0; i < lookups; i++)
+    {
+        size_t key = rng() % keys;
+        sections[i] = "section" + std::to_string(key / 100);
+        names[i] = (i % 10 == 9 ? "missing" : "key") + std::to_string(key);
+    }
+
+    double t0 = now_sec();
+    std::vector<INIReader> readers;
+    for (const std::string& text : texts)
+        readers.emplace_back(text.data(), text.size());
+    double t1 = now_sec();
+    std::vector<INILayeredReader::Source> sources;
+    for (const std::string& text : texts)
+        sources.push_back(INILayeredReader::Source::Text(text));
+    INILayeredReader layered(sources);
+    double t2 = now_sec();
+
+    double best_fall = 1e30, best_layered = 1e30;
+    size_t sink = 0;
+    for (int round = 0; round < 5; round++)
+    {
+        double r0 = now_sec();
+        for (size_t i = 0; i < lookups; i++)
+        {
+            // What callers had to do before: ask the layers top-down
+            for (size_t layer = readers.size(); layer-- > 0; )
+            {
+                if (readers[layer].HasValue(sections[i], names[i]))
+                {
+                    sink += readers[layer].GetView(sections[i], names[i], "").size();
+                    break;
+                }
+            }
+        }
+        double r1 = now_sec();
+        for (size_t i = 0; i < lookups; i++)
+            sink += layered.GetView(sections[i], names[i], "").size();
+        double r2 = now_sec();
+        best_fall = r1 - r0 < best_fall ? r1 - r0 : best_fall;
+        best_layered = r2 - r1 < best_layered ? r2 - r1 : best_layered;
+    }
+    if (sink == 1)
+        printf(" ");  // Keep the reads from being optimized away
+
+    size_t memory = 0;
+    for (const INIReader& reader : readers)
+        memory += reader.MemoryUsage().total;
+    printf("Usage: bench_ini_layered [keys] [lookups]\n");
+    printf("%zu keys, 4 layers, %zu lookups\n", keys, lookups);
+    printf("%-14s %14s %14s %10s\n", "", "construct ms", "ns/lookup", "MB");
+    printf("%-14s %14.1f %14.1f %10.1f\n", "fall-through", (t1 - t0) * 1e3, best_fall * 1e9 / lookups,
+           static_cast<double>(memory) / 1e6);
+    printf("%-14s %14.1f %14.1f %10.1f\n", "layered", (t2 - t1) * 1e3, best_layered * 1e9 / lookups,
+           static_cast<double>(layered.MemoryUsage().total) / 1e6);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// INIReader benchmark: construction time and memory of kEager, kLazy and
+// adopting (kAdopt) readers when only some of the keys are read.
+//
+// Usage: bench_ini_lazy [keys]
+//   keys  name=value pairs in the file (default 500000)
+//
+// Each row builds a fresh reader from the same text (adopt rows from a copy
+// of it, made outside the timing), then reads the given share of its keys
+// once. Memory is MemoryUsage().total after the reads; the text itself
+// isn't counted.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "INIReader.h"
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 100 sections of keys with 40-80 byte values; every 16th value continues
+// on a second line
+static std::string make_ini(size_t keys)
+{
+    std::string text;
+    for (size_t i = 0; i < keys; i++)
+    {
+        if (i % (keys / 100 + 1) == 0)
+            text += "[section" + std::to_string(i / (keys / 100 + 1)) + "]\n";
+        text += "key" + std::to_string(i) + " = value " + std::to_string(i) + " " +
+                std::string(32 + i % 41, 'x') + "\n";
+        if (i % 16 == 0)
+            text += "  continued " + std::to_string(i) + "\n";
+    }
+    return text;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t keys = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 500000;
+    std::string text = make_ini(keys);
+
+    std::vector<std::string> sections, names;
+    sections.reserve(keys);
+    names.reserve(keys);
+    for (size_t i = 0; i < keys; i++)
+    {
+        sections.push_back("section" + std::to_string(i / (keys / 100 + 1)));
+        names.push_back("key" + std::to_string(i));
+    }
+
+    printf("Usage: bench_ini_lazy [keys]\n");
+    printf("%zu keys, %.1f MB of text\n", keys, static_cast<double>(text.size()) / 1e6);
+    printf("%-6s %6s %14s %12s %10s\n", "mode", "read", "construct ms", "read ms", "MB");
+
+    const double shares[] = {0.01, 0.05, 1.0};
+    const char* variants[] = {"eager", "lazy", "adopt"};
+    size_t sink = 0;
+    for (const char* variant : variants)
+    {
+        for (double share : shares)
+        {
+            std::string copy = variant[0] == 'a' ? text : std::string();
+            double t0 = now_sec();
+            INIReader reader = variant[0] == 'a' ? INIReader(INIReader::kAdopt, std::move(copy))
+                : INIReader(text.data(), text.size(), variant[0] == 'l' ? INIReader::Mode::kLazy : INIReader::Mode::kEager);
+            double t1 = now_sec();
+            // Spread the reads over the whole file
+            size_t step = static_cast<size_t>(1.0 / share);
+            for (size_t i = 0; i < keys; i += step)
+                sink += reader.GetView(sections[i], names[i], "").size();
+            double t2 = now_sec();
+
+            printf("%-6s %5.0f%% %14.1f %12.1f %10.1f\n", variant, share * 100, (t1 - t0) * 1e3,
+                   (t2 - t1) * 1e3, static_cast<double>(reader.MemoryUsage().total) / 1e6);
+        }
+    }
+    if (sink == 1)
+        printf(" ");  // Keep the reads from being optimized away
+    return 0;
+}
@@ -0,0 +1,245 @@
+// INIReader benchmark: lookup cost (ns/op) against the previous
+// std::map<std::string, std::string> storage, at several key counts.
+//
+// Usage: bench_ini_lookup [key_counts] [lookups]
+//   key_counts  comma-separated (default 100,10000,1000000)
+//   lookups     lookups per measurement (default 2000000)
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "ini.h"
+#include "INIReader.h"
+
+// INIReader's storage before the flat hash index, kept here as the baseline
+class MapReader
+{
+public:
+    MapReader(const char* buffer, size_t size)
+    {
+        ini_parse_string_length_ex(buffer, size, ValueHandler, this);
+    }
+
+    std::string Get(const std::string& section, const std::string& name, const std::string& default_value) const
+    {
+        std::string key = MakeKey(section, name);
+        return _values.count(key) ? _values.find(key)->second : default_value;
+    }
+
+    bool HasValue(const std::string& section, const std::string& name) const
+    {
+        return _values.count(MakeKey(section, name)) != 0;
+    }
+
+    std::vector<std::string> Sections() const
+    {
+        std::set<std::string> sections;
+        for (const auto& value : _values)
+            sections.insert(value.first.substr(0, value.first.find('=')));
+        return std::vector<std::string>(sections.begin(), sections.end());
+    }
+
+    std::vector<std::string> Keys(const std::string& section) const
+    {
+        std::vector<std::string> keys;
+        std::string prefix = MakeKey(section, "");
+        for (const auto& value : _values)
+        {
+            if (value.first.compare(0, prefix.size(), prefix) == 0)
+                keys.push_back(value.first.substr(prefix.size()));
+        }
+        return keys;
+    }
+
+private:
+    static std::string MakeKey(const std::string& section, const std::string& name)
+    {
+        std::string key = section + "=" + name;
+        std::transform(key.begin(), key.end(), key.begin(),
+            [](const unsigned char& ch) { return static_cast<unsigned char>(::tolower(ch)); });
+        return key;
+    }
+
+    static int ValueHandler(void* user, const ini_entry* entry)
+    {
+        MapReader* reader = static_cast<MapReader*>(user);
+        std::string key = MakeKey(std::string(entry->section, entry->section_len),
+                                  std::string(entry->name, entry->name_len));
+        std::string& stored = reader->_values[key];
+        if (stored.size() > 0)
+            stored += "\n";
+        if (entry->value)
+            stored.append(entry->value, entry->value_len);
+        return 1;
+    }
+
+    std::map<std::string, std::string> _values;
+};
+
+struct Query
+{
+    std::string section;
+    std::string name;
+};
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Keys in sections of 100, with mixed-case queries in random order
+static std::string make_ini(size_t keys, std::vector<Query>& hits, std::vector<Query>& misses)
+{
+    std::string text;
+    std::mt19937_64 rng(1);
+
+    for (size_t i = 0; i < keys; i++)
+    {
+        if (i % 100 == 0)
+            text += "[Section" + std::to_string(i / 100) + "]\n";
+        text += "key_" + std::to_string(i) + " = " + std::to_string(rng() % 100000) + "\n";
+        hits.push_back(Query{"SECTION" + std::to_string(i / 100), "Key_" + std::to_string(i)});
+        misses.push_back(Query{"section" + std::to_string(i / 100), "nokey_" + std::to_string(i)});
+    }
+    std::shuffle(hits.begin(), hits.end(), rng);
+    std::shuffle(misses.begin(), misses.end(), rng);
+    return text;
+}
+
+template <class Lookup>
+static double ns_per_op(const std::vector<Query>& queries, size_t lookups, Lookup lookup)
+{
+    size_t sink = 0;
+    double best = 1e30;
+    for (int round = 0; round < 3; round++)
+    {
+        double t0 = now_sec();
+        for (size_t i = 0; i < lookups; i++)
+        {
+            const Query& q = queries[i % queries.size()];
+            sink += lookup(q);
+        }
+        double t = now_sec() - t0;
+        best = t < best ? t : best;
+    }
+    if (sink == 1)
+        printf(" ");  // Keep the lookups from being optimized away
+    return best * 1e9 / static_cast<double>(lookups);
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<size_t> counts = {100, 10000, 1000000};
+    size_t lookups = argc > 2 ? static_cast<size_t>(atol(argv[2])) : 2000000;
+
+    if (argc > 1)
+    {
+        counts.clear();
+        for (const char* p = argv[1]; *p; )
+        {
+            counts.push_back(static_cast<size_t>(atol(p)));
+            while (*p && *p != ',')
+                p++;
+            if (*p == ',')
+                p++;
+        }
+    }
+
+    printf("Usage: bench_ini_lookup [key_counts] [lookups]\n");
+    printf("%10s  %-22s %12s %12s\n", "keys", "operation", "std::map", "INIReader");
+    for (size_t keys : counts)
+    {
+        std::vector<Query> hits, misses;
+        std::string text = make_ini(keys, hits, misses);
+        MapReader map(text.data(), text.size());
+        INIReader reader(text.data(), text.size());
+        const std::string none;
+
+        double map_get = ns_per_op(hits, lookups, [&](const Query& q) {
+            return map.Get(q.section, q.name, none).size();
+        });
+        double reader_get = ns_per_op(hits, lookups, [&](const Query& q) {
+            return reader.Get(q.section, q.name, none).size();
+        });
+        printf("%10zu  %-22s %9.1f ns %9.1f ns\n", keys, "Get (hit)", map_get, reader_get);
+
+        double map_miss = ns_per_op(misses, lookups, [&](const Query& q) {
+            return static_cast<size_t>(map.HasValue(q.section, q.name));
+        });
+        double reader_miss = ns_per_op(misses, lookups, [&](const Query& q) {
+            return static_cast<size_t>(reader.HasValue(q.section, q.name));
+        });
+        printf("%10zu  %-22s %9.1f ns %9.1f ns\n", keys, "HasValue (miss)", map_miss, reader_miss);
+
+        // Allocation-free reads; the map baseline can only offer Get + strtol
+        double map_int = ns_per_op(hits, lookups, [&](const Query& q) {
+            return static_cast<size_t>(strtol(map.Get(q.section, q.name, none).c_str(), NULL, 0));
+        });
+        double reader_int = ns_per_op(hits, lookups, [&](const Query& q) {
+            return static_cast<size_t>(reader.GetInteger(q.section, q.name, 0));
+        });
+        printf("%10zu  %-22s %9.1f ns %9.1f ns\n", keys, "GetInteger (hit)", map_int, reader_int);
+        double reader_view = ns_per_op(hits, lookups, [&](const Query& q) {
+            return reader.GetView(q.section, q.name, std::string_view()).size();
+        });
+        printf("%10zu  %-22s %12s %9.1f ns\n", keys, "GetView (hit)", "-", reader_view);
+
+        // Handles resolved once up front, as a hot path would hold them
+        std::vector<INIReader::Handle> handles;
+        handles.reserve(hits.size());
+        for (const Query& q : hits)
+            handles.push_back(reader.Resolve(q.section, q.name));
+        size_t next = 0;
+        double handle_int = ns_per_op(hits, lookups, [&](const Query&) {
+            return static_cast<size_t>(reader.GetInteger(handles[next++ % handles.size()], 0));
+        });
+        printf("%10zu  %-22s %12s %9.1f ns\n", keys, "GetInteger (handle)", "-", handle_int);
+        next = 0;
+        double handle_real = ns_per_op(hits, lookups, [&](const Query&) {
+            return static_cast<size_t>(reader.GetReal(handles[next++ % handles.size()], 0));
+        });
+        printf("%10zu  %-22s %12s %9.1f ns\n", keys, "GetReal (handle)", "-", handle_real);
+        next = 0;
+        double handle_view = ns_per_op(hits, lookups, [&](const Query&) {
+            return reader.GetView(handles[next++ % handles.size()], std::string_view()).size();
+        });
+        printf("%10zu  %-22s %12s %9.1f ns\n", keys, "GetView (handle)", "-", handle_view);
+
+        // Listing calls are much slower on the map, so they run fewer times
+        // and are reported in microseconds
+        size_t listings = lookups / 10000 + 1;
+        double map_sections = ns_per_op(hits, listings, [&](const Query&) {
+            return map.Sections().size();
+        });
+        double reader_sections = ns_per_op(hits, listings, [&](const Query&) {
+            return reader.Sections().size();
+        });
+        printf("%10zu  %-22s %9.1f us %9.1f us\n", keys, "Sections()", map_sections / 1000, reader_sections / 1000);
+        double map_keys = ns_per_op(hits, listings, [&](const Query& q) {
+            return map.Keys(q.section).size();
+        });
+        double reader_keys = ns_per_op(hits, listings, [&](const Query& q) {
+            return reader.Keys(q.section).size();
+        });
+        printf("%10zu  %-22s %9.1f us %9.1f us\n", keys, "Keys(section)", map_keys / 1000, reader_keys / 1000);
+        double reader_items = ns_per_op(hits, listings, [&](const Query& q) {
+            size_t n = 0;
+            for (INIReader::Item item : reader.Items(q.section))
+                n += item.name.size();
+            return n;
+        });
+        printf("%10zu  %-22s %12s %9.1f us\n", keys, "Items(section)", "-", reader_items / 1000);
+
+        INIReader::MemoryStats memory = reader.MemoryUsage();
+        printf("%10zu  %-22s %12s %9.1f B  (%zu blocks)\n", keys, "Memory per key", "-",
+               static_cast<double>(memory.total) / static_cast<double>(keys), memory.allocations);
+    }
+    return 0;
+}
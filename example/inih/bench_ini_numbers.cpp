@@ -0,0 +1,85 @@
+// INIReader benchmark: cost of converting numeric values (ns/value) on
+// their first typed read, against calling strtoll/strtod on the same text.
+//
+// Usage: bench_ini_numbers [values]
+//   values  numeric values in the file (default 1000000)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include "INIReader.h"
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Half integers (decimal, negative and hex), half reals (fixed and exponent)
+static std::string make_ini(size_t values)
+{
+    std::string text = "[numbers]\n";
+    std::mt19937_64 rng(1);
+    char buffer[64];
+
+    for (size_t i = 0; i < values; i++)
+    {
+        uint64_t r = rng();
+        switch (i % 4)
+        {
+        case 0: snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(r % 2000000000) - 1000000000); break;
+        case 1: snprintf(buffer, sizeof(buffer), "0x%llx", static_cast<unsigned long long>(r >> 20)); break;
+        case 2: snprintf(buffer, sizeof(buffer), "%.6f", static_cast<double>(r % 100000000) / 1000.0); break;
+        default: snprintf(buffer, sizeof(buffer), "%.17g", static_cast<double>(r) * 1e-300); break;
+        }
+        text += "n" + std::to_string(i) + " = " + buffer + "\n";
+    }
+    return text;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t values = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 1000000;
+    std::string text = make_ini(values);
+
+    std::vector<std::string> names;
+    names.reserve(values);
+    for (size_t i = 0; i < values; i++)
+        names.push_back("n" + std::to_string(i));
+
+    double best_strto = 1e30, best_reader = 1e30;
+    double sink = 0;
+    for (int round = 0; round < 3; round++)
+    {
+        // A fresh reader each round, so every read is a first read
+        INIReader reader(text.data(), text.size());
+        std::vector<INIReader::Handle> handles;
+        handles.reserve(values);
+        for (const std::string& name : names)
+            handles.push_back(reader.Resolve("numbers", name));
+
+        double t0 = now_sec();
+        for (size_t i = 0; i < values; i++)
+        {
+            const char* value = reader.GetView(handles[i], std::string_view()).data();
+            sink += i % 4 < 2 ? static_cast<double>(strtoll(value, NULL, 0)) : strtod(value, NULL);
+        }
+        double t1 = now_sec();
+        for (size_t i = 0; i < values; i++)
+            sink += i % 4 < 2 ? static_cast<double>(reader.GetInteger64(handles[i], 0)) : reader.GetReal(handles[i], 0);
+        double t2 = now_sec();
+
+        best_strto = t1 - t0 < best_strto ? t1 - t0 : best_strto;
+        best_reader = t2 - t1 < best_reader ? t2 - t1 : best_reader;
+    }
+    if (sink == 1)
+        printf(" ");  // Keep the conversions from being optimized away
+
+    printf("Usage: bench_ini_numbers [values]\n");
+    printf("%10s  %12s %12s\n", "values", "strtoll/d", "INIReader");
+    printf("%10zu  %9.1f ns %9.1f ns\n", values,
+           best_strto * 1e9 / static_cast<double>(values), best_reader * 1e9 / static_cast<double>(values));
+    return 0;
+}
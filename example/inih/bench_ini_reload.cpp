@@ -0,0 +1,185 @@
+// ConfigPublisher benchmark: reads per second and read latency while a
+// writer keeps reloading the configuration, against a mutex-protected
+// INIReader and an atomically swapped std::shared_ptr<INIReader>.
+//
+// Usage: bench_ini_reload [threads] [seconds] [reload_ms]
+//   threads    reading threads (default: hardware concurrency)
+//   seconds    run time per variant (default 2)
+//   reload_ms  time between reloads (default 10)
+//
+// Each read takes the current configuration and reads three values from
+// it. Every 64th read is timed for the latency percentiles.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConfigSnapshot.h"
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// A config of 1000 keys; generation only changes the values
+static std::string make_ini(int generation)
+{
+    std::string text;
+    for (int i = 0; i < 1000; i++)
+    {
+        if (i % 50 == 0)
+            text += "[section" + std::to_string(i / 50) + "]\n";
+        text += "key" + std::to_string(i) + " = " + std::to_string(generation * 1000 + i) + "\n";
+    }
+    text += "[server]\nport = 8080\nhost = example.com\ntimeout = 2.5\n";
+    return text;
+}
+
+struct Result
+{
+    double reads_per_sec;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+    int reloads;
+};
+
+// Run read() on threads threads and reload() every reload_ms until seconds
+// have passed
+template <class Read, class Reload>
+static Result run(int threads, double seconds, int reload_ms, Read read, Reload reload)
+{
+    std::atomic<bool> stop(false);
+    std::atomic<long> total(0);
+    std::vector<std::vector<double>> samples(threads);
+    std::vector<std::thread> readers;
+
+    for (int t = 0; t < threads; t++)
+    {
+        readers.emplace_back([&, t] {
+            long reads = 0;
+            size_t sink = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                if (reads % 64 == 0)
+                {
+                    double t0 = now_sec();
+                    sink += read();
+                    samples[t].push_back(now_sec() - t0);
+                }
+                else
+                {
+                    sink += read();
+                }
+                reads++;
+            }
+            total += reads + (sink == 1 ? 1 : 0);
+        });
+    }
+
+    int reloads = 0;
+    double start = now_sec();
+    while (now_sec() - start < seconds)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(reload_ms));
+        reload(++reloads);
+    }
+    stop = true;
+    for (std::thread& reader : readers)
+        reader.join();
+    double elapsed = now_sec() - start;
+
+    std::vector<double> all;
+    for (const std::vector<double>& s : samples)
+        all.insert(all.end(), s.begin(), s.end());
+    std::sort(all.begin(), all.end());
+    Result result;
+    result.reads_per_sec = static_cast<double>(total.load()) / elapsed;
+    result.p50_ns = all.empty() ? 0 : all[all.size() / 2] * 1e9;
+    result.p99_ns = all.empty() ? 0 : all[all.size() * 99 / 100] * 1e9;
+    result.p999_ns = all.empty() ? 0 : all[all.size() * 999 / 1000] * 1e9;
+    result.reloads = reloads;
+    return result;
+}
+
+static size_t read_values(const INIReader& reader)
+{
+    return static_cast<size_t>(reader.GetInteger("server", "port", 0)) +
+           reader.GetView("server", "host", "").size() +
+           static_cast<size_t>(reader.GetInteger("section7", "key350", 0));
+}
+
+static void print(const char* name, const Result& r)
+{
+    printf("%-22s %12.0f %10.0f %10.0f %10.0f %8d\n", name, r.reads_per_sec, r.p50_ns, r.p99_ns, r.p999_ns, r.reloads);
+}
+
+int main(int argc, char* argv[])
+{
+    int threads = argc > 1 ? atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    double seconds = argc > 2 ? atof(argv[2]) : 2;
+    int reload_ms = argc > 3 ? atoi(argv[3]) : 10;
+    if (threads < 1)
+        threads = 1;
+
+    printf("Usage: bench_ini_reload [threads] [seconds] [reload_ms]\n");
+    printf("%d reading threads, reload every %d ms\n", threads, reload_ms);
+    printf("%-22s %12s %10s %10s %10s %8s\n", "variant", "reads/s", "p50 ns", "p99 ns", "p99.9 ns", "reloads");
+
+    {
+        std::mutex mutex;
+        std::string text = make_ini(0);
+        std::unique_ptr<INIReader> current(new INIReader(text.data(), text.size()));
+        Result r = run(threads, seconds, reload_ms,
+            [&] {
+                std::lock_guard<std::mutex> lock(mutex);
+                return read_values(*current);
+            },
+            [&](int generation) {
+                std::string next_text = make_ini(generation);
+                std::unique_ptr<INIReader> next(new INIReader(next_text.data(), next_text.size()));
+                std::lock_guard<std::mutex> lock(mutex);
+                current.swap(next);
+            });
+        print("mutex + INIReader", r);
+    }
+
+    {
+        std::string text = make_ini(0);
+        std::shared_ptr<const INIReader> current = std::make_shared<INIReader>(text.data(), text.size());
+        Result r = run(threads, seconds, reload_ms,
+            [&] {
+                std::shared_ptr<const INIReader> reader = std::atomic_load(&current);
+                return read_values(*reader);
+            },
+            [&](int generation) {
+                std::string next_text = make_ini(generation);
+                std::atomic_store(&current, std::shared_ptr<const INIReader>(
+                    std::make_shared<INIReader>(next_text.data(), next_text.size())));
+            });
+        print("atomic shared_ptr", r);
+    }
+
+    {
+        std::string text = make_ini(0);
+        ConfigPublisher publisher(std::unique_ptr<ConfigSnapshot>(new ConfigSnapshot(text.data(), text.size())));
+        Result r = run(threads, seconds, reload_ms,
+            [&] {
+                ConfigPublisher::ReadGuard snapshot = publisher.Read();
+                return read_values(*snapshot);
+            },
+            [&](int generation) {
+                std::string next_text = make_ini(generation);
+                publisher.Publish(std::unique_ptr<ConfigSnapshot>(
+                    new ConfigSnapshot(next_text.data(), next_text.size())));
+            });
+        print("ConfigPublisher", r);
+    }
+    return 0;
+}
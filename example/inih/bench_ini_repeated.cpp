@@ -0,0 +1,69 @@
+// INIReader benchmark: a key repeated many times with other keys in
+// between, as in a list of backends. Measures construction, reading the
+// values one by one with GetAll(), and the joined Get() form split again.
+//
+// Usage: bench_ini_repeated [repeats]
+//   repeats  times the key is given (default 10000)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include "INIReader.h"
+
+static double now_sec()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string make_ini(size_t repeats)
+{
+    std::string text = "[pool]\n";
+    for (size_t i = 0; i < repeats; i++)
+    {
+        text += "backend = 10.0." + std::to_string(i / 256 % 256) + "." + std::to_string(i % 256) + ":8080\n";
+        text += "weight" + std::to_string(i) + " = " + std::to_string(i % 10) + "\n";
+    }
+    return text;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t repeats = argc > 1 ? static_cast<size_t>(atol(argv[1])) : 10000;
+    std::string text = make_ini(repeats);
+
+    double best_construct = 1e30, best_all = 1e30, best_split = 1e30;
+    size_t sink = 0;
+    for (int round = 0; round < 5; round++)
+    {
+        double t0 = now_sec();
+        INIReader reader(text.data(), text.size());
+        double t1 = now_sec();
+        for (std::string_view backend : reader.GetAll("pool", "backend"))
+            sink += backend.size();
+        double t2 = now_sec();
+
+        // What callers had to do before GetAll(): split the joined value
+        std::string joined = reader.Get("pool", "backend", "");
+        for (size_t start = 0, end; start <= joined.size(); start = end + 1)
+        {
+            end = joined.find('\n', start);
+            if (end == std::string::npos)
+                end = joined.size();
+            sink += std::string_view(joined).substr(start, end - start).size();
+        }
+        double t3 = now_sec();
+
+        best_construct = t1 - t0 < best_construct ? t1 - t0 : best_construct;
+        best_all = t2 - t1 < best_all ? t2 - t1 : best_all;
+        best_split = t3 - t2 < best_split ? t3 - t2 : best_split;
+    }
+    if (sink == 1)
+        printf(" ");  // Keep the reads from being optimized away
+
+    printf("Usage: bench_ini_repeated [repeats]\n");
+    printf("%10s %14s %12s %14s\n", "repeats", "construct ms", "GetAll us", "Get+split us");
+    printf("%10zu %14.2f %12.1f %14.1f\n", repeats, best_construct * 1e3, best_all * 1e6, best_split * 1e6);
+    return 0;
+}
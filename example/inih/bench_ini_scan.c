@@ -0,0 +1,123 @@
+/* ini.h benchmark: throughput of the scalar/SSE2/AVX2 character scanners */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ini.h"
+
+static const char* level_names[] = {"scalar", "sse2", "avx2"};
+
+static double now_sec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int counter(void* user, const ini_entry* entry)
+{
+    (void)entry;
+    ++ *(size_t*)user;
+    return 1;
+}
+
+/* Repeat config/test.ini with numbered sections until size bytes */
+static char* make_test_ini(size_t size, size_t* length)
+{
+    char* buf = malloc(size + 512);
+    size_t len = 0;
+    int n = 0;
+
+    while (len < size)
+    {
+        len += (size_t)sprintf(buf + len,
+            "[protocol%d]               ; Protocol configuration\n"
+            "version=6                ; IPv6\n"
+            "\n"
+            "[user%d]\n"
+            "name = Bob Smith         ; Spaces around '=' are stripped\n"
+            "email = bob@smith.com    ; And comments (like this) ignored\n"
+            "active = true            ; Test a boolean\n"
+            "pi = 3.14159             ; Test a floating point number\n"
+            "trillion = 1000000000000 ; Test 64-bit integers\n", n, n);
+        n ++ ;
+    }
+    *length = len;
+    return buf;
+}
+
+/* Lines with values as long as INI_MAX_LINE allows, padded and commented */
+static char* make_long_values(size_t size, size_t* length)
+{
+    size_t value_len = INI_MAX_LINE - 40;
+    char* buf = malloc(size + INI_MAX_LINE * 2);
+    size_t len = 0;
+    size_t i;
+    int n = 0;
+
+    while (len < size)
+    {
+        if (n % 100 == 0)
+            len += (size_t)sprintf(buf + len, "[section%d]\n", n / 100);
+        len += (size_t)sprintf(buf + len, "key%d =    ", n);
+        for (i = 0; i < value_len; i++)
+            buf[len ++ ] = (char)('a' + (i * 7 + (size_t)n) % 26);
+        len += (size_t)sprintf(buf + len, "     ; c\n");
+        n ++ ;
+    }
+    *length = len;
+    return buf;
+}
+
+static void run(const char* name, const char* data, size_t length, int rounds)
+{
+    int level;
+    int max_level = ini_set_simd_level(INI_SIMD_AVX2);
+    double base = 0;
+
+    for (level = INI_SIMD_SCALAR; level <= max_level; level++)
+    {
+        double best = 1e30;
+        size_t entries = 0;
+        int r;
+
+        ini_set_simd_level(level);
+        for (r = 0; r < rounds; r++)
+        {
+            double t0 = now_sec();
+            entries = 0;
+            ini_parse_string_length_ex(data, length, counter, &entries);
+            t0 = now_sec() - t0;
+            if (t0 < best)
+                best = t0;
+        }
+        double mbps = (double)length / best / (1024.0 * 1024.0);
+        if (level == INI_SIMD_SCALAR)
+            base = mbps;
+        printf("%-12s %-7s %9.1f MB/s  %5.2fx  (%zu entries)\n",
+               name, level_names[level], mbps, mbps / base, entries);
+    }
+    ini_set_simd_level(max_level);
+}
+
+int main(int argc, char* argv[])
+{
+    size_t size = (argc > 1 ? (size_t)atol(argv[1]) : 64) << 20;
+    int rounds = argc > 2 ? atoi(argv[2]) : 5;
+    size_t length;
+    char* data;
+
+    printf("Usage: bench_ini_scan [size_mb] [rounds]\n");
+
+    data = make_test_ini(size, &length);
+    run("test.ini", data, length, rounds);
+    free(data);
+
+    data = make_long_values(size, &length);
+    run("long-values", data, length, rounds);
+    free(data);
+    return 0;
+}
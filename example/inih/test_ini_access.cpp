@@ -0,0 +1,139 @@
+// INIReader access report: read some keys (one misspelt, one that doesn't
+// convert) on a few threads, check the counts and list how each key was
+// read; the counts are also checked for two threads alternating between two
+// readers. Links against ini_stats, the library built with
+// INI_READER_STATS=1. Pass a file to report on it instead of the built-in
+// text.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "INIReader.h"
+
+static const INIReader::KeyAccess* find(const std::vector<INIReader::KeyAccess>& report,
+                                         const char* section, const char* name)
+{
+    for (const INIReader::KeyAccess& key : report)
+    {
+        if (key.section == section && key.name == name)
+            return &key;
+    }
+    return nullptr;
+}
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+// Each thread reads from both readers in turn, so neither reader's counts
+// come from one thread only
+static void check_alternating()
+{
+    const char text_a[] = "[a]\nx = 1\nword = abc\n";
+    const char text_b[] = "[b]\ny = on\n";
+    INIReader a(text_a, sizeof(text_a) - 1);
+    INIReader b(text_b, sizeof(text_b) - 1);
+    const int kRounds = 5000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; t++)
+    {
+        threads.emplace_back([&a, &b] {
+            for (int i = 0; i < kRounds; i++)
+            {
+                a.GetInteger("a", "x", 0);
+                b.GetBoolean("b", "y", false);
+                a.GetInteger("a", "word", 0);
+                b.GetView("b", "z", "");
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::vector<INIReader::KeyAccess> report_a = a.AccessReport();
+    std::vector<INIReader::KeyAccess> report_b = b.AccessReport();
+    const INIReader::KeyAccess* x = find(report_a, "a", "x");
+    const INIReader::KeyAccess* word = find(report_a, "a", "word");
+    const INIReader::KeyAccess* y = find(report_b, "b", "y");
+    const INIReader::KeyAccess* z = find(report_b, "b", "z");
+    check(!report_a.empty(), "counts (the library must be built with INI_READER_STATS=1)");
+    check(report_a.size() == 2 && report_b.size() == 2, "one row per key");
+    check(x && x->present && x->reads == 2 * kRounds && x->misses == 0 && x->fallbacks == 0, "a.x reads");
+    check(word && word->reads == 2 * kRounds && word->fallbacks == 2 * kRounds, "a.word fallbacks");
+    check(y && y->reads == 2 * kRounds && y->fallbacks == 0, "b.y reads");
+    check(z && !z->present && z->reads == 0 && z->misses == 2 * kRounds, "b.z misses");
+    printf("Alternating readers: counts OK\n");
+}
+
+static const char kText[] =
+    "[protocol]\n"
+    "version = 6\n"
+    "[user]\n"
+    "name = Bob Smith\n"
+    "email = bob@smith.com\n";
+
+int main(int argc, char* argv[])
+{
+    check_alternating();
+
+    std::string text(kText, sizeof(kText) - 1);
+    INIReader reader = argc > 1 ? INIReader(std::string(argv[1])) : INIReader(text.data(), text.size());
+    if (reader.ParseError() < 0)
+    {
+        printf("Can't load '%s'\n", argv[1]);
+        return 1;
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&reader, t] {
+            for (int i = 0; i < 1000 * (t + 1); i++)
+            {
+                reader.GetInteger("protocol", "version", -1);
+                reader.GetView("user", "name", "UNKNOWN");
+                reader.GetView("user", "emial", "UNKNOWN");     // Typo: a miss
+                reader.GetInteger("user", "name", 0);           // Not a number: a fallback
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::vector<INIReader::KeyAccess> report = reader.AccessReport();
+    printf("%-24s %-8s %10s %10s %10s\n", "key", "present", "reads", "misses", "fallbacks");
+    for (const INIReader::KeyAccess& key : report)
+    {
+        std::string name = key.section + "." + key.name;
+        printf("%-24s %-8s %10llu %10llu %10llu\n", name.c_str(), key.present ? "yes" : "NO",
+               static_cast<unsigned long long>(key.reads), static_cast<unsigned long long>(key.misses),
+               static_cast<unsigned long long>(key.fallbacks));
+    }
+    if (argc > 1)
+        return 0;
+
+    // Busiest first, ties by section and name, unread keys last
+    check(report.size() == 4, "one row per key");
+    const INIReader::KeyAccess& name = report[0];
+    const INIReader::KeyAccess& version = report[1];
+    const INIReader::KeyAccess& emial = report[2];
+    const INIReader::KeyAccess& email = report[3];
+    check(name.section == "user" && name.name == "name" && name.present, "user.name first");
+    check(name.reads == 20000 && name.misses == 0 && name.fallbacks == 10000, "user.name counts");
+    check(version.section == "protocol" && version.name == "version", "protocol.version second");
+    check(version.reads == 10000 && version.misses == 0 && version.fallbacks == 0, "protocol.version counts");
+    check(emial.name == "emial" && !emial.present, "user.emial third");
+    check(emial.reads == 0 && emial.misses == 10000 && emial.fallbacks == 0, "user.emial counts");
+    check(email.name == "email" && email.present, "unread user.email last");
+    check(email.reads == 0 && email.misses == 0 && email.fallbacks == 0, "user.email counts");
+    printf("test_ini_access: OK\n");
+    return 0;
+}
@@ -0,0 +1,98 @@
+// INIReader kAdopt test: a reader that takes over a std::string or
+// std::vector<char> must read back what a reader copying the same text
+// does, however the caller reuses the variable it moved the text out of.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "INIReader.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+// Every value of every key, read as text
+static std::string dump(const INIReader& reader)
+{
+    std::string out;
+    for (const INIReader::Item& item : reader)
+    {
+        out += std::string(item.section) + "." + std::string(item.name) + "=" +
+               reader.Get(item.section, item.name, "?") + "|";
+        for (std::string_view piece : reader.GetAll(item.section, item.name))
+            out += "<" + std::string(piece) + ">";
+        out += "\n";
+    }
+    return out;
+}
+
+// Adopt text from a std::string, then overwrite the moved-from string
+static void check_string(const std::string& text, const char* what)
+{
+    std::string expected = dump(INIReader(text.data(), text.size()));
+    std::string source = text;
+    INIReader reader(INIReader::kAdopt, std::move(source));
+    source.assign(text.size() + 64, '#');
+    check(reader.ParseError() == 0, what);
+    check(dump(reader) == expected, what);
+
+    // Single-line values are read in place, NUL-terminated
+    std::string_view port = reader.GetView("server", "port", "");
+    check(port == "8080" && port.data()[port.size()] == '\0', what);
+
+    // Views outlive a move of the reader
+    INIReader moved(std::move(reader));
+    source.clear();
+    check(port == "8080" && dump(moved) == expected, what);
+}
+
+int main()
+{
+    // Short enough to fit in std::string's own buffer, so a move copies it
+    check_string("[server]\nport = 8080\n", "short string");
+
+    std::string text =
+        "[server]\n"
+        "port = 8080\n"
+        "hosts = a\n"
+        "  b\n"
+        "name = x ; comment\n"
+        "[client]\n"
+        "retry = 3\n"
+        "retry = 4\n"
+        "empty =\n";
+    for (int i = 0; i < 100; i++)
+        text += "key" + std::to_string(i) + " = value " + std::to_string(i) + "\n";
+    text += "last = no newline";
+    check_string(text, "long string");
+
+    INIReader copied(text.data(), text.size());
+    check(copied.Get("server", "hosts", "") == "a\nb", "hosts");
+    check(copied.Get("client", "retry", "") == "3\n4", "retry");
+
+    // std::vector<char>, without a NUL at the end
+    std::vector<char> bytes(text.begin(), text.end());
+    INIReader from_vector(INIReader::kAdopt, std::move(bytes));
+    bytes.assign(16, '#');
+    check(dump(from_vector) == dump(copied), "vector");
+    check(from_vector.GetView("client", "last", "") == "no newline", "vector last line");
+
+    // A copy shares the adopted text and outlives the original
+    INIReader* original = new INIReader(INIReader::kAdopt, std::string(text));
+    INIReader copy(*original);
+    delete original;
+    check(dump(copy) == dump(copied), "copy");
+
+    // Errors are reported as for any other text
+    std::string bad = "[ok]\nk = v\nno equals sign\n";
+    check(INIReader(INIReader::kAdopt, std::move(bad)).ParseError() == 3, "parse error");
+
+    printf("test_ini_adopt: OK\n");
+    return 0;
+}
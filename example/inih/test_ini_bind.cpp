@@ -0,0 +1,270 @@
+// ini_bind.hpp test: the strict value parsers accept whole valid values
+// only, the compile-time perfect-hash schema finds every field (and nothing
+// else) case-insensitively, and ini::bind() over inline text assigns known
+// keys, reports unknown ones, rejects bad values, and treats repeated keys
+// and continuation lines as INIReader does: joined with "\n" into strings,
+// appended to vectors, and an error for any other member.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "INIReader.h"
+#include "ini_bind.hpp"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+// Parse value into a T that starts out as sentinel; on rejection the
+// sentinel must be left alone
+template <class T>
+static bool parses(std::string_view value, T expected, T sentinel = T())
+{
+    T out = sentinel;
+    return ini::value_parser<T>::parse(value, out) && out == expected;
+}
+
+template <class T>
+static bool rejects(std::string_view value, T sentinel = T())
+{
+    T out = sentinel;
+    return !ini::value_parser<T>::parse(value, out) && out == sentinel;
+}
+
+static void check_integers()
+{
+    check(parses<int>("42", 42) && parses<int>("-42", -42) && parses<int>("+7", 7), "decimal");
+    check(parses<int>("0x1F", 31) && parses<int>("0X1f", 31) && parses<int>("-0x10", -16), "hex");
+    check(parses<int>("010", 8) && parses<int>("0", 0) && parses<int>("-0", 0), "octal and zero");
+    check(parses<int>("2147483647", 2147483647) && parses<int>("-2147483648", -2147483647 - 1), "int limits");
+    check(rejects<int>("2147483648", 5) && rejects<int>("-2147483649", 5), "int out of range");
+    check(rejects<int>("", 5) && rejects<int>("-", 5) && rejects<int>("0x", 5), "no digits");
+    check(rejects<int>("12abc", 5) && rejects<int>("1.5", 5) && rejects<int>("1 ", 5) && rejects<int>(" 1", 5),
+          "trailing or leading junk");
+    check(rejects<int>("08", 5) && rejects<int>("0x1G", 5), "digit out of base");
+    check(rejects<int>("--1", 5) && rejects<int>("+-1", 5) && rejects<int>("abc", 5), "bad sign");
+
+    check(parses<uint8_t>("255", 255) && parses<uint8_t>("0xff", 255) && parses<uint8_t>("-0", 0), "uint8_t");
+    check(rejects<uint8_t>("256", 1) && rejects<uint8_t>("-1", 1), "uint8_t out of range");
+    check(parses<int8_t>("-128", -128) && rejects<int8_t>("128", 1) && rejects<int8_t>("-129", 1), "int8_t");
+    check(parses<int64_t>("-9223372036854775808", std::numeric_limits<int64_t>::min()) &&
+          parses<int64_t>("9223372036854775807", std::numeric_limits<int64_t>::max()) &&
+          rejects<int64_t>("9223372036854775808", 1), "int64_t limits");
+    check(parses<uint64_t>("18446744073709551615", std::numeric_limits<uint64_t>::max()) &&
+          rejects<uint64_t>("18446744073709551616", 1) && rejects<uint64_t>("-5", 1), "uint64_t limits");
+}
+
+static void check_reals_and_booleans()
+{
+    check(parses<double>("1.5", 1.5) && parses<double>("-2.5e3", -2500) && parses<double>("+0.25", 0.25),
+          "reals");
+    check(parses<double>("3", 3) && parses<float>("0.5", 0.5f), "integral real, float");
+    check(rejects<double>("", 9) && rejects<double>("1.5x", 9) && rejects<double>("+-1", 9) &&
+          rejects<double>(" 1", 9) && rejects<double>("0x10", 9) && rejects<double>("-0x1p3", 9) &&
+          rejects<double>("1e999", 9) && rejects<float>("1e39", 9) && rejects<double>("-", 9),
+          "bad reals");
+    check(parses<double>("inf", std::numeric_limits<double>::infinity()) &&
+          parses<double>("-Infinity", -std::numeric_limits<double>::infinity()) &&
+          parses<double>(".5", 0.5) && parses<double>("1e-3", 0.001), "infinities and forms");
+
+    for (std::string_view yes : {"true", "TRUE", "Yes", "on", "1"})
+        check(parses<bool>(yes, true, false), "true values");
+    for (std::string_view no : {"false", "No", "OFF", "0"})
+        check(parses<bool>(no, false, true), "false values");
+    for (std::string_view bad : {"", "2", "t", "yess", "enabled", " on"})
+        check(rejects<bool>(bad, true), "bad booleans");
+
+    check(parses<std::string>("any thing", "any thing", "x") && parses<std::string>("", "", "x"), "strings");
+}
+
+struct config
+{
+    std::string host = "localhost";
+    int port = 80;
+    double timeout = 1.5;
+    bool debug = false;
+    uint16_t retries = 3;
+    std::vector<std::string> aliases;
+    std::vector<int> ports;
+    std::string_view tag;
+    // Keys whose hashes are arranged differently: ("ab", "c") vs ("a", "bc")
+    int ab_c = 0;
+    int a_bc = 0;
+    // Padding fields so that several share a displacement group
+    int f1 = 0, f2 = 0, f3 = 0, f4 = 0, f5 = 0, f6 = 0, f7 = 0, f8 = 0;
+};
+
+constexpr auto config_schema = ini::fields(
+    ini::field("server", "host", &config::host),
+    ini::field("server", "port", &config::port),
+    ini::field("server", "timeout", &config::timeout),
+    ini::field("Server", "Debug", &config::debug),
+    ini::field("server", "retries", &config::retries),
+    ini::field("server", "alias", &config::aliases),
+    ini::field("listen", "port", &config::ports),
+    ini::field("", "tag", &config::tag),
+    ini::field("ab", "c", &config::ab_c),
+    ini::field("a", "bc", &config::a_bc),
+    ini::field("extra", "f1", &config::f1),
+    ini::field("extra", "f2", &config::f2),
+    ini::field("extra", "f3", &config::f3),
+    ini::field("extra", "f4", &config::f4),
+    ini::field("extra", "f5", &config::f5),
+    ini::field("extra", "f6", &config::f6),
+    ini::field("extra", "f7", &config::f7),
+    ini::field("extra", "f8", &config::f8));
+
+// Every field is found at its own index, in any case, and near misses
+// aren't; all of it at compile time
+constexpr bool schema_finds_all()
+{
+    constexpr std::string_view keys[][2] = {
+        {"server", "host"}, {"server", "port"}, {"server", "timeout"}, {"server", "debug"},
+        {"server", "retries"}, {"server", "alias"}, {"listen", "port"}, {"", "tag"},
+        {"ab", "c"}, {"a", "bc"}, {"extra", "f1"}, {"extra", "f2"}, {"extra", "f3"},
+        {"extra", "f4"}, {"extra", "f5"}, {"extra", "f6"}, {"extra", "f7"}, {"extra", "f8"},
+    };
+    for (std::size_t i = 0; i < config_schema.size; i++)
+    {
+        if (config_schema.find(keys[i][0], keys[i][1]) != i)
+            return false;
+    }
+    return true;
+}
+
+static_assert(config_schema.size == 18, "schema size");
+static_assert(schema_finds_all(), "every field found at its index");
+static_assert(config_schema.find("SERVER", "HOST") == 0 && config_schema.find("server", "DEBUG") == 3,
+              "lookups ignore case");
+static_assert(config_schema.find("server", "hosts") == config_schema.size &&
+              config_schema.find("server", "hos") == config_schema.size &&
+              config_schema.find("listen", "host") == config_schema.size &&
+              config_schema.find("", "port") == config_schema.size &&
+              config_schema.find("abc", "") == config_schema.size &&
+              config_schema.find("extra", "f9") == config_schema.size,
+              "unknown keys not found");
+
+static const char kText[] =
+    "tag = top level\n"                 // 1
+    "[Server]\n"                        // 2
+    "HOST = first\n"                    // 3
+    "host = second\n"                   // 4: repeated, joined
+    "port = 8080\n"                     // 5
+    "port = 80x\n"                      // 6: repeated scalar, rejected
+    "timeout = 2.5\n"                   // 7
+    "debug = yes\n"                     // 8
+    "retries = 70000\n"                 // 9: out of range for uint16_t
+    "alias = a\n"                       // 10
+    "  b\n"                             // 11: continuation appends
+    "alias = c\n"                       // 12
+    "host = third\n"                    // 13
+    "  fourth\n"                        // 14: continuation, joined
+    "unknown = 1\n"                     // 15
+    "[listen]\n"                        // 16
+    "port = 1\n"                        // 17
+    "port = bad\n"                      // 18: rejected, not appended
+    "port = 0x10\n"                     // 19
+    "[ab]\n"                            // 20
+    "c = 5\n"                           // 21
+    "[a]\n"                             // 22
+    "bc = 6\n"                          // 23
+    "[other]\n"                         // 24
+    "host = elsewhere\n";               // 25
+
+// Dialects that also call back for new sections and names without values
+struct section_dialect : ini::default_dialect
+{
+    static constexpr bool call_handler_on_new_section = true;
+};
+
+struct no_value_dialect : ini::default_dialect
+{
+    static constexpr bool allow_no_value = true;
+};
+
+static void check_bind()
+{
+    std::string text(kText, sizeof(kText) - 1);
+    config c;
+    std::vector<std::string> unknown;
+    int error = ini::bind(text, c, config_schema, [&unknown](const ini::entry& e) {
+        unknown.push_back(std::string(e.section) + "." + std::string(e.name) + "@" + std::to_string(e.lineno));
+    });
+    check(error == 6, "first bad value's line");
+    check(c.host == "first\nsecond\nthird\nfourth", "repeated key and continuations joined");
+    check(c.host == INIReader(text.data(), text.size()).Get("server", "host", ""), "string as INIReader::Get()");
+    check(c.port == 8080, "rejected value leaves the member alone");
+    check(c.timeout == 2.5 && c.debug, "real and boolean");
+    check(c.retries == 3, "out-of-range value rejected");
+    check((c.aliases == std::vector<std::string>{"a", "b", "c"}), "vector appends, continuation too");
+    check((c.ports == std::vector<int>{1, 16}), "bad vector element not appended");
+    check(c.tag == "top level", "string_view value");
+    check(c.tag.data() >= text.data() && c.tag.data() < text.data() + text.size(), "string_view into buffer");
+    check(c.ab_c == 5 && c.a_bc == 6, "section/name boundary in the hash");
+    check(c.f1 == 0, "absent field keeps its value");
+    check((unknown == std::vector<std::string>{"Server.unknown@15", "other.host@25"}), "unknown keys");
+
+    // Without a callback unknown keys are skipped; the result is the same
+    config quiet;
+    check(ini::bind(text, quiet, config_schema) == 6, "bind without callback");
+    check(quiet.host == c.host && quiet.aliases == c.aliases, "same result without callback");
+
+    // All valid: no error
+    config clean;
+    check(ini::bind("[server]\nport = 0x1F\n[listen]\nport = 1\n", clean, config_schema) == 0, "no error");
+    check(clean.port == 31 && clean.ports.size() == 1, "clean values");
+
+    // New-section callbacks aren't unknown keys
+    config sections;
+    int calls = 0;
+    check(ini::bind<section_dialect>("[server]\nport = 1\n[x]\n", sections, config_schema,
+                                     [&calls](const ini::entry&) { calls++; }) == 0, "new-section dialect");
+    check(calls == 0 && sections.port == 1, "new sections not reported");
+
+    // A scalar can't hold a second value: repeated keys and continuations
+    // are errors and the first value stays
+    config scalar;
+    check(ini::bind("[server]\nport = 1\nport = 2\n", scalar, config_schema) == 3 && scalar.port == 1,
+          "repeated scalar rejected");
+    check(ini::bind("[server]\nport = 5\n  6\n", scalar, config_schema) == 3 && scalar.port == 5,
+          "continuation into a scalar rejected");
+    check(ini::bind("tag = a\n  b\n", scalar, config_schema) == 2 && scalar.tag == "a",
+          "continuation into a string_view rejected");
+    check(ini::bind("[server]\nport = x\nport = 7\n", scalar, config_schema) == 2 && scalar.port == 7,
+          "a rejected value doesn't count as the first");
+
+    // Multiline strings read the same as through INIReader
+    const char multiline[] = "[server]\nhost = a\n  b\n\n  c\n[listen]\nport = 1\n  2\n";
+    config joined;
+    check(ini::bind(multiline, joined, config_schema) == 0, "multiline parse");
+    INIReader reader(multiline, sizeof(multiline) - 1);
+    check(joined.host == reader.Get("server", "host", "?") && joined.host == "a\nb\nc", "multiline string");
+    check((joined.ports == std::vector<int>{1, 2}), "continuation appends to a vector");
+
+    // A known key without a value is an error, an unknown one is reported
+    config no_value;
+    unknown.clear();
+    error = ini::bind<no_value_dialect>("[server]\nport = 1\nflag\nport\n", no_value, config_schema,
+                                        [&unknown](const ini::entry& e) { unknown.push_back(std::string(e.name)); });
+    check(error == 4 && no_value.port == 1, "known key without a value rejected");
+    check((unknown == std::vector<std::string>{"flag"}), "unknown key without a value reported");
+}
+
+int main()
+{
+    check_integers();
+    check_reals_and_booleans();
+    check_bind();
+
+    printf("test_ini_bind: OK\n");
+    return 0;
+}
@@ -0,0 +1,304 @@
+// INICache test: reads through the compiled image must equal INIReader's,
+// a stale image (source size, mtime, content or parser options changed) must
+// be rebuilt, and a truncated or damaged image must be rebuilt or served
+// without reading out of bounds, never crash. Build with -fsanitize=address
+// to have the byte-flip pass checked for out-of-bounds reads as well.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+#include "INICache.h"
+#include "INIReader.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+static const char kSource[] = "test_ini_cache.ini";
+static const char kCache[] = "test_ini_cache.ini.cache";
+
+static const char kText[] =
+    "top = level\n"
+    "[Server]\n"
+    "port = 8080 ; inline comment\n"
+    "hosts = a\n"
+    "  b\n"
+    "  c\n"
+    "ratio = 0.5\n"
+    "big = 18446744073709551615\n"
+    "negative = -42\n"
+    "hex = 0x1F\n"
+    "[client]\n"
+    "retry = 3\n"
+    "retry = 4\n"
+    "debug = on\n"
+    "Verbose = FALSE\n"
+    "empty =\n"
+    "[server]\n"
+    "name = again\n"
+    "[last]\n"
+    "key = no newline";
+
+// Every getter over every key, plus keys and sections that aren't there,
+// as text; sections and keys are sorted, as INICache keeps them sorted
+template <class Reader>
+static std::string dump(const Reader& reader)
+{
+    std::vector<std::string> sections = reader.Sections();
+    for (std::string& section : sections)
+        for (char& c : section)
+            c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    std::sort(sections.begin(), sections.end());
+    sections.push_back("missing");
+
+    std::string out;
+    for (const std::string& section : sections)
+    {
+        std::string upper = section;
+        for (char& c : upper)
+            c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        out += "[" + section + "] " + std::to_string(reader.HasSection(section)) +
+               std::to_string(reader.HasSection(upper)) + "\n";
+
+        std::vector<std::string> keys = reader.Keys(section);
+        for (std::string& key : keys)
+            for (char& c : key)
+                c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        std::sort(keys.begin(), keys.end());
+        keys.push_back("missing");
+        for (const std::string& name : keys)
+        {
+            out += name + "=" + reader.Get(section, name, "?") + "|";
+            out += std::string(reader.GetView(upper, name, "?")) + "|";
+            out += reader.GetString(section, name, "?") + "|";
+            out += std::to_string(reader.GetInteger(section, name, -1)) + "|";
+            out += std::to_string(reader.GetInteger64(section, name, -1)) + "|";
+            out += std::to_string(reader.GetUnsigned(section, name, 7)) + "|";
+            out += std::to_string(reader.GetUnsigned64(section, name, 7)) + "|";
+            out += std::to_string(reader.GetReal(section, name, -1)) + "|";
+            out += std::to_string(reader.GetBoolean(section, name, false)) + "|";
+            out += std::to_string(reader.HasValue(section, name)) + "\n";
+        }
+    }
+    return out;
+}
+
+static void write_file(const char* filename, const std::string& data)
+{
+    FILE* file = fopen(filename, "wb");
+    check(file != nullptr, "create file");
+    check(fwrite(data.data(), 1, data.size(), file) == data.size(), "write file");
+    fclose(file);
+}
+
+static std::string read_file(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    check(file != nullptr, "open file");
+    std::string data;
+    char block[4096];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), file)) > 0)
+        data.append(block, n);
+    fclose(file);
+    return data;
+}
+
+static struct timespec mtime_of(const char* filename)
+{
+    struct stat sb;
+    check(stat(filename, &sb) == 0, "stat");
+    return sb.st_mtim;
+}
+
+static void set_mtime(const char* filename, struct timespec mtime)
+{
+    struct timespec times[2] = {mtime, mtime};
+    check(utimensat(AT_FDCWD, filename, times, 0) == 0, "set mtime");
+}
+
+enum Expect { kRebuild, kCached, kEither };
+
+// Load through the cache and check that it was rebuilt or served from the
+// image as expected. Whatever the image holds, reading it must not crash;
+// only a damaged image that got past the load-time checks may read
+// differently from INIReader
+static void load(const std::string& expected, Expect expect, const char* what)
+{
+    INICache cache(kSource);
+    check(cache.ParseError() == 0, what);
+    std::string result = dump(cache);
+    if (expect == kRebuild)
+        check(!cache.FromCache(), what);
+    else if (expect == kCached)
+        check(cache.FromCache(), what);
+    if (expect != kEither || !cache.FromCache())
+        check(result == expected, what);
+}
+
+// Offsets in the image, as laid out in INICache.cpp: an 88-byte header,
+// then the entry and section tables (16 bytes per row, four uint32 fields
+// each), the displacement table and the slot table
+static const size_t kHeaderSize = 88;
+static const size_t kSeedOffset = 56;
+
+static uint32_t header_field(const std::string& image, size_t offset)
+{
+    uint32_t n;
+    memcpy(&n, image.data() + offset, sizeof(n));
+    return n;
+}
+
+// Truncating the image, or flipping a byte of it, must never crash; damage
+// the load-time checks are there to catch must be rebuilt
+static void check_damaged(const std::string& expected)
+{
+    remove(kCache);
+    load(expected, kRebuild, "build image");
+    load(expected, kCached, "load image");
+    const std::string image = read_file(kCache);
+    check(image.size() > kHeaderSize, "image size");
+
+    for (size_t size = 0; size < image.size(); size++)
+    {
+        write_file(kCache, image.substr(0, size));
+        load(expected, kRebuild, "truncated image rebuilt");
+    }
+
+    // Any flip in the header but the hash seed fails a header check
+    for (size_t i = 0; i < kHeaderSize; i++)
+    {
+        if (i >= kSeedOffset && i < kSeedOffset + 8)
+            continue;
+        std::string damaged = image;
+        damaged[i] ^= 0x10;
+        write_file(kCache, damaged);
+        load(expected, kRebuild, "damaged header rebuilt");
+    }
+
+    // Setting the top bit of any offset, length, index or count in the
+    // entry, section and slot tables takes it out of range, which
+    // CheckTables() must catch
+    uint32_t entry_count = header_field(image, 64);
+    uint32_t section_count = header_field(image, 68);
+    uint32_t group_count = header_field(image, 72);
+    uint32_t slot_count = header_field(image, 76);
+    size_t slots = kHeaderSize + (size_t(entry_count) + section_count) * 16 + size_t(group_count) * 4;
+    std::vector<size_t> fields;
+    for (size_t off = kHeaderSize; off < kHeaderSize + (size_t(entry_count) + section_count) * 16; off += 4)
+        fields.push_back(off);
+    for (size_t off = slots; off < slots + size_t(slot_count) * 4; off += 4)
+        fields.push_back(off);
+    for (size_t off : fields)
+    {
+        std::string damaged = image;
+        damaged[off + 3] ^= 0x80;  // Little-endian: the field's top byte
+        write_file(kCache, damaged);
+        load(expected, kRebuild, "out-of-range table field rebuilt");
+    }
+
+    // Any other single-bit flip may go unnoticed (a value byte, a
+    // displacement), but it must not make a read leave the image
+    for (size_t i = 0; i < image.size(); i++)
+    {
+        for (int bit = 0; bit < 8; bit++)
+        {
+            std::string damaged = image;
+            damaged[i] ^= static_cast<char>(1 << bit);
+            write_file(kCache, damaged);
+            load(expected, kEither, "flipped byte");
+        }
+    }
+
+    write_file(kCache, image);
+    load(expected, kCached, "restored image");
+}
+
+int main()
+{
+    std::string text(kText, sizeof(kText) - 1);
+    write_file(kSource, text);
+    remove(kCache);
+    INIReader reader(kSource);
+    check(reader.ParseError() == 0, "parse");
+    const std::string expected = dump(reader);
+
+    // Parsed and cached, then served from the image
+    {
+        INICache cache(kSource);
+        check(cache.ParseError() == 0 && !cache.FromCache(), "first load parses");
+        check(dump(cache) == expected, "parsed reads equal INIReader");
+    }
+    {
+        INICache cache(kSource);
+        check(cache.ParseError() == 0 && cache.FromCache(), "second load from cache");
+        check(dump(cache) == expected, "cached reads equal INIReader");
+        check(cache.GetView("server", "hosts", "") == "a\nb\nc", "multiline");
+        check(cache.Get("CLIENT", "RETRY", "") == "3\n4", "repeated key");
+        check(cache.GetView("client", "empty", "?").data()[0] == '\0', "values NUL-terminated");
+    }
+
+    // Same size and mtime, different content: only the hash tells
+    struct timespec mtime = mtime_of(kSource);
+    std::string same_size = text;
+    same_size[same_size.find("8080")] = '9';
+    write_file(kSource, same_size);
+    set_mtime(kSource, mtime);
+    std::string changed = dump(INIReader(kSource));
+    check(changed != expected, "content changed");
+    load(changed, kRebuild, "content change rebuilds");
+    load(changed, kCached, "rebuilt image loads");
+
+    // Size changed
+    write_file(kSource, text + "\n[added]\nkey = 1\n");
+    changed = dump(INIReader(kSource));
+    load(changed, kRebuild, "size change rebuilds");
+    load(changed, kCached, "rebuilt image loads");
+
+    // Same content, only the mtime changed
+    write_file(kSource, text);
+    load(expected, kRebuild, "rewrite rebuilds");
+    mtime = mtime_of(kSource);
+    mtime.tv_sec -= 10;
+    set_mtime(kSource, mtime);
+    load(expected, kRebuild, "mtime change rebuilds");
+    load(expected, kCached, "rebuilt image loads");
+
+    // An image built under other parser options: the header's options hash
+    // (offset 16) no longer matches this build's
+    {
+        std::string image = read_file(kCache);
+        image[16] ^= 0x01;
+        write_file(kCache, image);
+        load(expected, kRebuild, "options change rebuilds");
+        load(expected, kCached, "rebuilt image loads");
+    }
+
+    // An image that can't be written is not an error
+    {
+        INICache cache(kSource, "test_ini_cache.missing/test.cache");
+        check(cache.ParseError() == 0 && !cache.FromCache(), "unwritable cache");
+        check(dump(cache) == expected, "unwritable cache reads");
+    }
+
+    check_damaged(expected);
+
+    check(INICache("test_ini_cache.missing").ParseError() == -1, "missing file");
+
+    remove(kCache);
+    remove(kSource);
+    printf("test_ini_cache: OK\n");
+    return 0;
+}
@@ -0,0 +1,117 @@
+// INIReader::GetAll() test: the range holds one view per line of a value,
+// empty lines included, in every mode, and Get() joins the same lines the
+// way inih always has, which drops empty lines at the start.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "INIReader.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+static std::vector<std::string> all(const INIReader::ValueRange& range)
+{
+    std::vector<std::string> pieces;
+    for (std::string_view piece : range)
+        pieces.push_back(std::string(piece));
+    return pieces;
+}
+
+// inih's join: "\n" before each line once something has been joined
+static std::string join(const std::vector<std::string>& pieces)
+{
+    std::string value;
+    for (const std::string& piece : pieces)
+    {
+        if (!value.empty())
+            value += "\n";
+        value += piece;
+    }
+    return value;
+}
+
+struct Expected
+{
+    const char* name;
+    std::vector<std::string> pieces;
+    const char* joined;
+};
+
+static void check_reader(const INIReader& reader, const std::vector<Expected>& keys, const char* what)
+{
+    check(reader.ParseError() == 0, what);
+    for (const Expected& key : keys)
+    {
+        INIReader::ValueRange range = reader.GetAll("s", key.name);
+        check(all(range) == key.pieces, what);
+        check(range.size() == key.pieces.size() && range.empty() == key.pieces.empty(), what);
+        check(all(reader.GetAll(reader.Resolve("s", key.name))) == key.pieces, what);
+        check(reader.Get("s", key.name, "?") == (key.pieces.empty() ? "?" : key.joined), what);
+        check(key.pieces.empty() || join(key.pieces) == key.joined, what);
+    }
+}
+
+int main()
+{
+    const std::string text =
+        "[s]\n"
+        "single = one\n"
+        "empty =\n"
+        "lead =\n"       // Lines "" and "a": Get() is "a"
+        "  a\n"
+        "middle = x\n"
+        "middle =\n"
+        "middle = y\n"
+        "trail = a\n"
+        "trail =\n"
+        "blanks =\n"
+        "blanks =\n"
+        "cont = first\n"
+        "  second\n"
+        "  third\n"
+        "mixed = 1\n"
+        "  2\n"
+        "mixed = 3\n";
+    const std::vector<Expected> keys = {
+        {"single", {"one"}, "one"},
+        {"empty", {""}, ""},
+        {"lead", {"", "a"}, "a"},
+        {"middle", {"x", "", "y"}, "x\n\ny"},
+        {"trail", {"a", ""}, "a\n"},
+        {"blanks", {"", ""}, ""},
+        {"cont", {"first", "second", "third"}, "first\nsecond\nthird"},
+        {"mixed", {"1", "2", "3"}, "1\n2\n3"},
+        {"missing", {}, ""},
+    };
+
+    check_reader(INIReader(text.data(), text.size()), keys, "eager");
+    check_reader(INIReader(text.data(), text.size(), INIReader::Mode::kLazy), keys, "lazy");
+    check_reader(INIReader(INIReader::kAdopt, std::string(text)), keys, "adopt");
+
+    // Joining the range by hand keeps the empty first line Get() drops
+    INIReader reader(text.data(), text.size());
+    std::string by_hand;
+    const char* separator = "";
+    for (std::string_view piece : reader.GetAll("s", "lead"))
+    {
+        by_hand += separator + std::string(piece);
+        separator = "\n";
+    }
+    check(by_hand == "\na" && reader.Get("s", "lead", "") == "a", "leading empty line");
+
+    // A missing key's range is empty, and so is an empty handle's
+    check(reader.GetAll("s", "missing").begin() == reader.GetAll("s", "missing").end(), "missing range");
+    check(reader.GetAll(INIReader::Handle()).empty(), "empty handle range");
+    check(INIReader::ValueRange().size() == 0, "default range");
+
+    printf("test_ini_getall: OK\n");
+    return 0;
+}
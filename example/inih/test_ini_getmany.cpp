@@ -0,0 +1,164 @@
+// INIReader::GetMany() test: every result must match the single-key getter
+// for its request's type, across several prefetch batches, with missing
+// keys and values that don't convert, and leave the other members alone.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "INIReader.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+typedef INIReader::KeyRequest Request;
+
+static const char* const kValues[] = {
+    "42", "-7", "0x1f", "3.5", "1e3", "yes", "off", "word", "", "18446744073709551615", "a\nb",
+};
+
+// A result with every member set to a recognisable default
+static INIReader::Result defaults()
+{
+    INIReader::Result result;
+    result.found = true;
+    result.string = "default";
+    result.integer = -99;
+    result.unsigned_integer = 99;
+    result.real = -9.5;
+    result.boolean = true;
+    return result;
+}
+
+// Check one result against the getter for its type. A key is found if it
+// exists and converts, which shows as the getter ignoring its default.
+static void check_result(const INIReader& reader, const Request& request, const INIReader::Result& result)
+{
+    INIReader::Result other = defaults();
+    std::string_view section = request.section, name = request.name;
+    bool found = false;
+    switch (request.type)
+    {
+    case Request::kString:
+        found = reader.HasValue(section, name);
+        check(result.string == reader.GetView(section, name, other.string), "string");
+        break;
+    case Request::kInteger:
+        found = reader.GetInteger64(section, name, 1) == reader.GetInteger64(section, name, 2);
+        check(result.integer == reader.GetInteger64(section, name, other.integer), "integer");
+        break;
+    case Request::kUnsigned:
+        found = reader.GetUnsigned64(section, name, 1) == reader.GetUnsigned64(section, name, 2);
+        check(result.unsigned_integer == reader.GetUnsigned64(section, name, other.unsigned_integer),
+              "unsigned");
+        break;
+    case Request::kReal:
+        found = reader.GetReal(section, name, 1) == reader.GetReal(section, name, 2);
+        check(result.real == reader.GetReal(section, name, other.real), "real");
+        break;
+    case Request::kBoolean:
+        found = reader.GetBoolean(section, name, false) == reader.GetBoolean(section, name, true);
+        check(result.boolean == reader.GetBoolean(section, name, other.boolean), "boolean");
+        break;
+    }
+    check(result.found == found, "found");
+
+    // Members for other types keep their defaults
+    if (request.type != Request::kString)
+        check(result.string == other.string, "string left alone");
+    if (request.type != Request::kInteger)
+        check(result.integer == other.integer, "integer left alone");
+    if (request.type != Request::kUnsigned)
+        check(result.unsigned_integer == other.unsigned_integer, "unsigned left alone");
+    if (request.type != Request::kReal)
+        check(result.real == other.real, "real left alone");
+    if (request.type != Request::kBoolean)
+        check(result.boolean == other.boolean, "boolean left alone");
+}
+
+static void check_reader(const INIReader& reader, const std::vector<std::string>& sections,
+                         const std::vector<std::string>& names)
+{
+    // Every key as every type, with a missing name or section after each,
+    // so batches mix hits and misses
+    std::vector<Request> requests;
+    const Request::Type types[] = {Request::kString, Request::kInteger, Request::kUnsigned,
+                                   Request::kReal, Request::kBoolean};
+    for (size_t s = 0; s < sections.size(); s++)
+    {
+        for (size_t n = 0; n < names.size(); n++)
+        {
+            for (Request::Type type : types)
+            {
+                requests.push_back(Request{sections[s], names[n], type});
+                requests.push_back(Request{sections[s], "missing", type});
+            }
+        }
+        requests.push_back(Request{"nosuch", names[0], Request::kString});
+    }
+    check(requests.size() % 16 != 0, "last batch is partial");
+
+    std::vector<INIReader::Result> results(requests.size(), defaults());
+    reader.GetMany(requests.data(), results.data(), requests.size());
+    for (size_t i = 0; i < requests.size(); i++)
+        check_result(reader, requests[i], results[i]);
+}
+
+int main()
+{
+    std::string text;
+    std::vector<std::string> sections, names;
+    for (int s = 0; s < 3; s++)
+    {
+        sections.push_back("Section" + std::to_string(s));
+        text += "[" + sections.back() + "]\n";
+        for (size_t v = 0; v < sizeof(kValues) / sizeof(kValues[0]); v++)
+        {
+            std::string value = kValues[(v + s) % (sizeof(kValues) / sizeof(kValues[0]))];
+            if (value == "a\nb")
+                value = "a\n  b";
+            text += "Key" + std::to_string(v) + " = " + value + "\n";
+        }
+    }
+    for (size_t v = 0; v < sizeof(kValues) / sizeof(kValues[0]); v++)
+        names.push_back("key" + std::to_string(v));
+
+    INIReader eager(text.data(), text.size());
+    check(eager.ParseError() == 0, "parse");
+    check_reader(eager, sections, names);
+    check_reader(INIReader(text.data(), text.size(), INIReader::Mode::kLazy), sections, names);
+
+    // A few values spelled out
+    Request requests[] = {
+        {"section0", "key0", Request::kInteger},
+        {"SECTION0", "KEY3", Request::kReal},
+        {"section0", "key5", Request::kBoolean},
+        {"section0", "key7", Request::kInteger},
+        {"section0", "key10", Request::kString},
+        {"section0", "absent", Request::kInteger},
+    };
+    INIReader::Result results[6];
+    for (INIReader::Result& result : results)
+        result = defaults();
+    eager.GetMany(requests, results, 6);
+    check(results[0].found && results[0].integer == 42, "key0");
+    check(results[1].found && results[1].real == 3.5, "key3");
+    check(results[2].found && results[2].boolean, "key5");
+    check(!results[3].found && results[3].integer == -99, "word isn't an integer");
+    check(results[4].found && results[4].string == "a\nb", "multi-line");
+    check(!results[5].found && results[5].integer == -99, "absent");
+
+    // An empty reader finds nothing, and no requests is fine
+    INIReader empty("", 0);
+    check_reader(empty, sections, names);
+    empty.GetMany(nullptr, nullptr, 0);
+
+    printf("test_ini_getmany: OK\n");
+    return 0;
+}
@@ -0,0 +1,84 @@
+// INIReader::Handle test: every getter read through a resolved key must
+// return what the same getter returns by name, including for missing keys,
+// mixed case, multi-line values and a key read as several types.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "INIReader.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+int main()
+{
+    const char text[] =
+        "[Server]\n"
+        "Port = 8080\n"
+        "ratio = 0.25\n"
+        "debug = yes\n"
+        "name = front end\n"
+        "hosts = a\n"
+        "  b\n"
+        "big = 18446744073709551615\n"
+        "negative = -5\n"
+        "empty =\n";
+    INIReader reader(text, sizeof(text) - 1);
+    check(reader.ParseError() == 0, "parse");
+
+    const char* names[] = {"port", "ratio", "debug", "name", "hosts", "big", "negative", "empty", "missing"};
+    for (const char* name : names)
+    {
+        INIReader::Handle key = reader.Resolve("server", name);
+        check(static_cast<bool>(key) == reader.HasValue("server", name), "handle found");
+        check(reader.HasValue(key) == reader.HasValue("server", name), "HasValue");
+        check(reader.Get(key, "def") == reader.Get("server", name, "def"), "Get");
+        check(reader.GetView(key, "def") == reader.GetView("server", name, "def"), "GetView");
+        check(reader.GetString(key, "def") == reader.GetString("server", name, "def"), "GetString");
+        check(reader.GetInteger(key, -1) == reader.GetInteger("server", name, -1), "GetInteger");
+        check(reader.GetInteger64(key, -1) == reader.GetInteger64("server", name, -1), "GetInteger64");
+        check(reader.GetUnsigned(key, 7) == reader.GetUnsigned("server", name, 7), "GetUnsigned");
+        check(reader.GetUnsigned64(key, 7) == reader.GetUnsigned64("server", name, 7), "GetUnsigned64");
+        check(reader.GetReal(key, -1) == reader.GetReal("server", name, -1), "GetReal");
+        check(reader.GetBoolean(key, false) == reader.GetBoolean("server", name, false), "GetBoolean");
+        check(reader.GetBoolean(key, true) == reader.GetBoolean("server", name, true), "GetBoolean default");
+    }
+
+    // Values themselves, so the comparison above isn't between two wrong answers
+    INIReader::Handle port = reader.Resolve("SERVER", "PORT");
+    check(port && reader.GetInteger(port, 0) == 8080, "port");
+    check(reader.GetReal(port, 0) == 8080.0, "port as real");
+    check(reader.GetInteger(port, 0) == 8080, "port again after real");
+    check(reader.GetView(port, "") == "8080", "port as text");
+    check(reader.GetReal(reader.Resolve("server", "ratio"), 0) == 0.25, "ratio");
+    check(reader.GetInteger(reader.Resolve("server", "name"), -1) == -1, "name isn't an integer");
+    check(reader.GetBoolean(reader.Resolve("server", "debug"), false), "debug");
+    check(reader.Get(reader.Resolve("server", "hosts"), "") == "a\nb", "hosts");
+    check(reader.GetUnsigned64(reader.Resolve("server", "big"), 0) == UINT64_MAX, "big");
+    check(reader.GetInteger64(reader.Resolve("server", "big"), 1) == INT64_MAX, "big clamps like strtoll");
+    check(reader.GetInteger(reader.Resolve("server", "negative"), 0) == -5, "negative");
+    check(reader.GetView(reader.Resolve("server", "empty"), "def") == "", "empty");
+
+    // An empty handle reads as missing
+    INIReader::Handle missing = reader.Resolve("server", "missing");
+    check(!missing && !reader.HasValue(missing), "missing");
+    check(reader.GetView(missing, "def") == "def", "missing default");
+    check(!reader.Resolve("nosuch", "port"), "missing section");
+    check(!INIReader::Handle(), "default handle");
+    check(reader.GetInteger(INIReader::Handle(), 3) == 3, "default handle reads default");
+
+    // Handles and views stay valid when the reader is moved
+    std::string_view name = reader.GetView(reader.Resolve("server", "name"), "");
+    INIReader moved(std::move(reader));
+    check(moved.GetInteger(port, 0) == 8080, "handle after move");
+    check(name == "front end" && moved.GetView("server", "name", "") == name, "view after move");
+
+    printf("test_ini_handle: OK\n");
+    return 0;
+}
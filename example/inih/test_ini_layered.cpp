@@ -0,0 +1,104 @@
+// INILayeredReader test: the highest layer that sets a key wins, Layer()
+// names it (or is -1), repeated keys join within a layer but not across
+// layers, and each layer's parse error is kept apart.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "INILayeredReader.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+static std::vector<std::string> all(const INIReader::ValueRange& range)
+{
+    std::vector<std::string> pieces;
+    for (std::string_view piece : range)
+        pieces.push_back(std::string(piece));
+    return pieces;
+}
+
+int main()
+{
+    const std::string defaults =
+        "[server]\n"
+        "port = 80\n"
+        "host = localhost\n"
+        "hosts = a\n"
+        "  b\n"
+        "timeout = 30\n"
+        "[log]\n"
+        "level = info\n";
+    const std::string site =
+        "[Server]\n"
+        "PORT = 8080\n"
+        "hosts = c\n"
+        "[log]\n"
+        "file = /var/log/app\n"
+        "file = /tmp/app\n";
+    const char* filename = "test_ini_layered.ini";
+    FILE* file = fopen(filename, "wb");
+    check(file != nullptr, "create file");
+    fputs("[server]\nport = 9090\n[extra]\nflag = on\n", file);
+    fclose(file);
+
+    INILayeredReader config({INILayeredReader::Source::Text(defaults),
+                             INILayeredReader::Source::Text(site),
+                             INILayeredReader::Source::File(filename),
+                             INILayeredReader::Source::File("test_ini_layered.missing")});
+    remove(filename);
+
+    // The missing file is reported for its layer only
+    check(config.LayerCount() == 4, "LayerCount");
+    check(config.LayerError(0) == 0 && config.LayerError(1) == 0 && config.LayerError(2) == 0, "LayerError");
+    check(config.LayerError(3) == -1 && config.ParseError() == -1, "missing layer");
+
+    // Highest layer wins, whatever the case it was written in
+    check(config.GetInteger("server", "port", 0) == 9090 && config.Layer("server", "port") == 2, "port");
+    check(config.Get("server", "host", "") == "localhost" && config.Layer("SERVER", "Host") == 0, "host");
+    check(config.GetInteger("server", "timeout", 0) == 30 && config.Layer("server", "timeout") == 0, "timeout");
+    check(config.GetBoolean("extra", "flag", false) && config.Layer("extra", "flag") == 2, "flag");
+    check(config.Get("log", "level", "") == "info" && config.Layer("log", "level") == 0, "level");
+    check(config.Layer("server", "missing") == -1 && config.Layer("nosuch", "port") == -1, "missing key");
+    check(config.Layer(config.Resolve("server", "port")) == 2, "Layer(Handle)");
+    check(config.Layer(config.Resolve("server", "missing")) == -1, "Layer(empty Handle)");
+
+    // A higher layer replaces a multi-line value outright; within a layer
+    // repeated keys still join
+    check(config.Get("server", "hosts", "") == "c" && config.Layer("server", "hosts") == 1, "hosts");
+    check(all(config.GetAll("server", "hosts")) == std::vector<std::string>{"c"}, "hosts range");
+    check(config.Get("log", "file", "") == "/var/log/app\n/tmp/app" && config.Layer("log", "file") == 1,
+          "file");
+    check(all(config.GetAll("log", "file")) == std::vector<std::string>{"/var/log/app", "/tmp/app"},
+          "file range");
+
+    // Sections and keys are the union of the layers, each key once
+    check(config.Sections() == std::vector<std::string>{"extra", "log", "server"}, "Sections");
+    std::vector<std::string_view> order(config.SectionNames().begin(), config.SectionNames().end());
+    check(order == std::vector<std::string_view>{"server", "log", "extra"}, "SectionNames");
+    check(config.Keys("server") == std::vector<std::string>{"host", "hosts", "port", "timeout"}, "Keys");
+    check(config.size() == 7, "size");
+
+    // A parse error is the line in its own layer
+    INILayeredReader errors({INILayeredReader::Source::Text("[a]\nx = 1\n"),
+                             INILayeredReader::Source::Text("[a]\nx = 2\nno equals sign\ny = 3\n")});
+    check(errors.LayerError(0) == 0 && errors.LayerError(1) == 3 && errors.ParseError() == 3, "error line");
+    check(errors.GetInteger("a", "x", 0) == 2 && errors.Layer("a", "y") == 1, "values after error");
+
+    // One layer, and no layers at all
+    INILayeredReader one({INILayeredReader::Source::Text(defaults)});
+    check(one.Layer("server", "port") == 0 && one.GetInteger("server", "port", 0) == 80, "one layer");
+    INILayeredReader none(std::vector<INILayeredReader::Source>{});
+    check(none.LayerCount() == 0 && none.ParseError() == 0 && none.size() == 0, "no layers");
+    check(none.Layer("server", "port") == -1, "no layers Layer");
+
+    printf("test_ini_layered: OK\n");
+    return 0;
+}
@@ -0,0 +1,124 @@
+// INIReader kLazy test: a kLazy reader, over a buffer or a mapped file,
+// must read back exactly what a kEager reader of the same text does,
+// including when several threads make the first read of a value at once
+// and after the file has been replaced by rename().
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include "INIReader.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+static const char kText[] =
+    "top = level\n"
+    "[Server]\n"
+    "port = 8080 ; inline comment\n"
+    "hosts = a\n"
+    "  b\n"
+    "  c\n"
+    "ratio = 0.5\n"
+    "[client]\n"
+    "retry = 3\n"
+    "retry = 4\n"
+    "debug = on\n"
+    "empty =\n"
+    "[server]\n"
+    "name = again\n"
+    "last = no newline";
+
+// Everything lazy reads, as text: first reads and repeated reads of each
+// key by every getter, in a fixed order
+static std::string dump(const INIReader& reader)
+{
+    std::string out;
+    for (const std::string& section : reader.Sections())
+    {
+        out += "[" + section + "]\n";
+        for (const std::string& name : reader.Keys(section))
+        {
+            out += name + "=" + reader.Get(section, name, "?") + "|";
+            out += std::string(reader.GetView(section, name, "?")) + "|";
+            out += std::to_string(reader.GetInteger(section, name, -1)) + "|";
+            out += std::to_string(reader.GetReal(section, name, -1)) + "|";
+            out += std::to_string(reader.GetBoolean(section, name, false)) + "|";
+            for (std::string_view piece : reader.GetAll(section, name))
+                out += "<" + std::string(piece) + ">";
+            out += "\n";
+        }
+        for (const INIReader::Item& item : reader.Items(section))
+            out += std::string(item.name) + ":" + std::string(item.value) + "\n";
+    }
+    for (const INIReader::Item& item : reader)
+        out += std::string(item.section) + "." + std::string(item.name) + ":" + std::string(item.value) + "\n";
+    return out;
+}
+
+static void write_file(const char* filename, const std::string& text)
+{
+    FILE* file = fopen(filename, "wb");
+    check(file != nullptr, "create file");
+    check(fwrite(text.data(), 1, text.size(), file) == text.size(), "write file");
+    fclose(file);
+}
+
+int main()
+{
+    std::string text(kText, sizeof(kText) - 1);
+    INIReader eager(text.data(), text.size());
+    check(eager.ParseError() == 0, "parse");
+    std::string expected = dump(eager);
+    check(eager.Get("server", "hosts", "") == "a\nb\nc", "hosts");
+    check(eager.Get("client", "retry", "") == "3\n4", "retry");
+
+    // Buffer: nothing but names is copied until a value is read
+    INIReader lazy(text.data(), text.size(), INIReader::Mode::kLazy);
+    check(lazy.ParseError() == 0, "lazy parse");
+    check(lazy.size() == eager.size(), "lazy size");
+    check(lazy.MemoryUsage().strings < eager.MemoryUsage().strings, "lazy copies fewer strings");
+    check(dump(lazy) == expected, "lazy buffer");
+    check(dump(lazy) == expected, "lazy buffer, second read");
+
+    // Several threads making the first read of each value at once
+    INIReader shared(text.data(), text.size(), INIReader::Mode::kLazy);
+    std::vector<std::string> dumps(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < dumps.size(); t++)
+        threads.emplace_back([&shared, &dumps, t] { dumps[t] = dump(shared); });
+    for (std::thread& thread : threads)
+        thread.join();
+    for (const std::string& result : dumps)
+        check(result == expected, "lazy first reads on several threads");
+
+    // Mapped file, and a copy that outlives the original reader
+    const char* filename = "test_ini_lazy.ini";
+    write_file(filename, text);
+    INIReader* mapped = new INIReader(filename, INIReader::Mode::kLazy);
+    check(mapped->ParseError() == 0, "lazy file parse");
+    check(dump(*mapped) == expected, "lazy file");
+    INIReader copy(*mapped);
+    delete mapped;
+    check(dump(copy) == expected, "copy of lazy file reader");
+
+    // Replacing the file with rename() leaves the reader on the old text
+    INIReader before(filename, INIReader::Mode::kLazy);
+    write_file("test_ini_lazy.new", "[server]\nport = 1\n");
+    check(rename("test_ini_lazy.new", filename) == 0, "rename");
+    check(dump(before) == expected, "lazy file after rename");
+    check(INIReader(filename, INIReader::Mode::kLazy).GetInteger("server", "port", 0) == 1, "new file");
+    remove(filename);
+
+    check(INIReader("test_ini_lazy.missing", INIReader::Mode::kLazy).ParseError() == -1, "missing file");
+
+    printf("test_ini_lazy: OK\n");
+    return 0;
+}
@@ -0,0 +1,181 @@
+// ConfigPublisher test: readers holding ReadGuards while a writer keeps
+// publishing must each see one whole snapshot, and a replaced snapshot
+// must not be deleted while any guard that could see it is alive.
+//
+// Build with -fsanitize=thread or -fsanitize=address to also have the
+// sanitizers watch the publish/read path.
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConfigSnapshot.h"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+static const int kGenerations = 2000;
+static const int kKeys = 32;
+
+// Set by each snapshot's destructor, indexed by generation
+static std::atomic<bool> g_destroyed[kGenerations + 1];
+static std::atomic<int> g_destroyed_count(0);
+
+// Every value in generation g's text is g
+static std::string make_ini(int generation)
+{
+    std::string text = "[meta]\ngeneration = " + std::to_string(generation) + "\n[values]\n";
+    for (int i = 0; i < kKeys; i++)
+        text += "key" + std::to_string(i) + " = " + std::to_string(generation) + "\n";
+    return text;
+}
+
+// A snapshot that records when it's destroyed
+class CountedSnapshot : public ConfigSnapshot
+{
+public:
+    explicit CountedSnapshot(int generation)
+        : CountedSnapshot(make_ini(generation), generation)
+    {
+    }
+
+    ~CountedSnapshot() override
+    {
+        check(!g_destroyed[_generation].exchange(true), "snapshot destroyed twice");
+        g_destroyed_count++;
+    }
+
+private:
+    CountedSnapshot(const std::string& text, int generation)
+        : ConfigSnapshot(text.data(), text.size()), _generation(generation)
+    {
+    }
+
+    int _generation;
+};
+
+static std::unique_ptr<ConfigSnapshot> make_snapshot(int generation)
+{
+    return std::unique_ptr<ConfigSnapshot>(new CountedSnapshot(generation));
+}
+
+// Check that the guard's snapshot is whole and still alive; return its
+// generation
+static long check_snapshot(const ConfigPublisher::ReadGuard& snapshot)
+{
+    check(static_cast<bool>(snapshot), "snapshot published");
+    long generation = snapshot->GetInteger("meta", "generation", -1);
+    check(generation >= 1 && generation <= kGenerations, "generation in range");
+    check(!g_destroyed[generation].load(), "snapshot alive while guarded");
+    check(snapshot->Version() == static_cast<uint64_t>(generation), "version matches generation");
+    for (int i = 0; i < kKeys; i++)
+        check(snapshot->GetInteger("values", "key" + std::to_string(i), -1) == generation,
+              "every value from the same generation");
+    check(!g_destroyed[generation].load(), "snapshot alive at end of guard");
+    return generation;
+}
+
+// One thread: a guard taken before two publishes keeps both replaced
+// snapshots alive until it's released
+static void check_single_thread()
+{
+    {
+        ConfigPublisher publisher;
+        check(!publisher.Read(), "nothing published");
+        check(publisher.Version() == 0, "no version");
+    }
+
+    for (int g = 1; g <= 3; g++)
+        g_destroyed[g] = false;
+    g_destroyed_count = 0;
+    {
+        ConfigPublisher publisher(make_snapshot(1));
+        {
+            ConfigPublisher::ReadGuard old = publisher.Read();
+            check(check_snapshot(old) == 1, "first snapshot");
+            publisher.Publish(make_snapshot(2));
+            {
+                ConfigPublisher::ReadGuard nested = publisher.Read();
+                check(check_snapshot(nested) == 2, "nested guard sees the new snapshot");
+            }
+            publisher.Publish(make_snapshot(3));
+            check(publisher.Reclaim() == 2, "both replaced snapshots held by the guard");
+            check(g_destroyed_count == 0, "nothing freed while guarded");
+            check(check_snapshot(old) == 1, "guard unchanged by publishes");
+        }
+        check(publisher.Reclaim() == 0, "replaced snapshots freed once unguarded");
+        check(g_destroyed[1] && g_destroyed[2] && !g_destroyed[3], "the replaced ones are freed");
+        check(publisher.Version() == 3, "current version");
+        publisher.Publish(nullptr);
+        check(publisher.Version() == 3 && check_snapshot(publisher.Read()) == 3, "null publish ignored");
+    }
+    check(g_destroyed[3] && g_destroyed_count == 3, "publisher frees the current snapshot");
+}
+
+// Readers take guards while a writer publishes every generation in turn
+static void check_concurrent(int readers)
+{
+    for (int g = 1; g <= kGenerations; g++)
+        g_destroyed[g] = false;
+    g_destroyed_count = 0;
+    {
+        ConfigPublisher publisher(make_snapshot(1));
+        std::atomic<bool> done(false);
+        std::atomic<int> started(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < readers; t++)
+        {
+            threads.emplace_back([&publisher, &done, &started] {
+                long last = 0;
+                started++;
+                while (!done.load())
+                {
+                    ConfigPublisher::ReadGuard snapshot = publisher.Read();
+                    long generation = check_snapshot(snapshot);
+                    check(generation >= last, "generations never go backwards");
+                    last = generation;
+                    // Hold the guard across a yield so that publishes and
+                    // reclaims happen while it's alive
+                    std::this_thread::yield();
+                    check(check_snapshot(snapshot) == generation, "guard sees one snapshot");
+                }
+            });
+        }
+        while (started.load() < readers)
+            std::this_thread::yield();
+        for (int g = 2; g <= kGenerations; g++)
+        {
+            publisher.Publish(make_snapshot(g));
+            if (g % 64 == 0)
+                publisher.Reclaim();
+        }
+        done = true;
+        for (std::thread& thread : threads)
+            thread.join();
+
+        check(publisher.Reclaim() == 0, "all replaced snapshots freed after readers finish");
+        check(g_destroyed_count == kGenerations - 1, "every replaced snapshot freed once");
+        check(!g_destroyed[kGenerations], "current snapshot alive");
+        check(publisher.Version() == kGenerations, "last version");
+    }
+    check(g_destroyed_count == kGenerations, "publisher frees the current snapshot");
+}
+
+int main()
+{
+    check_single_thread();
+    unsigned cores = std::thread::hardware_concurrency();
+    check_concurrent(cores < 2 ? 2 : cores > 8 ? 8 : static_cast<int>(cores));
+
+    printf("test_ini_snapshot: OK\n");
+    return 0;
+}
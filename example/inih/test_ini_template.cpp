@@ -0,0 +1,147 @@
+// ini.hpp test: ini::parse<default_dialect>() must report the same
+// (section, name, value, lineno, offset) stream and the same first error
+// line as ini_parse_string_length_ex() over the test_ini_parse.cpp inputs.
+//
+// default_dialect takes its options from the INI_* macros, so this file is
+// built together with ini.c once per combination of the dialect options
+// (see xmake.lua: test_ini_template_0 .. test_ini_template_63), and each
+// binary checks the template parser against the C parser built the same
+// way.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ini.hpp"
+
+static void check(bool ok, const char* what)
+{
+    if (!ok)
+    {
+        printf("FAILED: %s\n", what);
+        exit(1);
+    }
+}
+
+// Same inputs as test_ini_parse.cpp, plus a few lines whose meaning
+// depends on the dialect
+struct Case
+{
+    const char* name;
+    std::string text;
+};
+
+// NUL at the start of a line, in a continuation, in a value and in a
+// section name
+static const char kNul[] = "[s]\n\0x = 1\n  \0y\nk = a\0b\n[t\0]\n\0";
+
+static std::vector<Case> cases()
+{
+    return {
+        {"basic", "; comment\n[section]\nname = value\nother=2\n\n[second]\nname = again\n"},
+        {"no section", "top = 1\n[s]\nk = v\n"},
+        {"continuation", "[multi]\nkey = first\n  second\n\tthird\nnext = 1\n  more\n"},
+        {"repeated key", "[r]\nk = 1\nk = 2\nk = 3\n"},
+        {"inline comment", "[c]\nk = value ; comment\nq = a;b\nz = x # not a comment\n"},
+        {"bom", "\xEF\xBB\xBF[bom]\nk = v\n"},
+        {"long line", "[long]\nkey = " + std::string(INI_MAX_LINE + 50, 'x') + "\nafter = 1\n"},
+        {"errors", "[ok]\nk = v\nno equals sign\n[unclosed\nafter = 1\n"},
+        {"error first line", "garbage\n[s]\nk = v\n"},
+        {"no final newline", "[s]\nk = v\nlast = 1"},
+        {"crlf", "[s]\r\nk = v\r\n  cont\r\nq = 2\r\n"},
+        {"empty values", "[e]\nk =\nq = \n  cont\n"},
+        {"empty", ""},
+        {"continuation across sections", "[a]\nk = 1\n[b]\n  orphan\nj = 2\n\n  more\n[c]\n  again\n"},
+        {"comment after =", "[c]\nk =; c\nq = ; c\nz =\t;c\nw = x;y ; z\n"},
+        {"bom then error", "\xEF\xBB\xBFgarbage\n[s]\nk = v\n"},
+        {"dialect lines", "  indented = 1\n[s] ; note\nflag\n  cont ; c\nk : v\n# hash\n[t]\n  orphan\n"},
+        {"long names", "[" + std::string(INI_MAX_SECTION + 10, 's') + "]\n" +
+                       std::string(INI_MAX_NAME + 10, 'n') + " = v\n  cont\n"},
+        {"nul", std::string(kNul, sizeof(kNul) - 1)},
+    };
+}
+
+static void record(std::string* out, std::string_view section, const char* name, size_t name_len,
+                   const char* value, size_t value_len, int lineno, size_t offset)
+{
+    *out += std::string(section) + "|";
+    *out += name ? std::string(name, name_len) : "(null)";
+    *out += "|";
+    *out += value ? std::string(value, value_len) : "(null)";
+    *out += "|" + std::to_string(lineno) + "|" + std::to_string(offset) + "\n";
+}
+
+// Rejecting an entry makes its line an error; reject values "v" in one
+// pass to compare that too
+struct Recorder
+{
+    bool reject_v;
+    std::string out;
+
+    bool accept(const char* value, size_t value_len) const
+    {
+        return !reject_v || !value || std::string_view(value, value_len) != "v";
+    }
+};
+
+static int c_handler(void* user, const ini_entry* e)
+{
+    Recorder* recorder = static_cast<Recorder*>(user);
+    record(&recorder->out, std::string_view(e->section, e->section_len), e->name, e->name_len, e->value,
+           e->value_len, e->lineno, e->offset);
+    return recorder->accept(e->value, e->value_len);
+}
+
+static int c_parse(const std::string& text, bool reject_v, std::string* out)
+{
+    Recorder recorder{reject_v, std::string()};
+    int error = ini_parse_string_length_ex(text.data(), text.size(), c_handler, &recorder);
+    *out = recorder.out;
+    return error;
+}
+
+static int template_parse(const std::string& text, bool reject_v, std::string* out)
+{
+    Recorder recorder{reject_v, std::string()};
+    int error = ini::parse(text, [&recorder](const ini::entry& e) {
+        record(&recorder.out, e.section, e.name.data(), e.name.size(), e.value.data(), e.value.size(), e.lineno,
+               e.offset);
+        return recorder.accept(e.value.data(), e.value.size());
+    });
+    *out = recorder.out;
+    return error;
+}
+
+int main()
+{
+    printf("multiline=%d bom=%d inline_comments=%d no_value=%d stop_on_first_error=%d "
+           "call_handler_on_new_section=%d\n",
+           INI_ALLOW_MULTILINE, INI_ALLOW_BOM, INI_ALLOW_INLINE_COMMENTS, INI_ALLOW_NO_VALUE,
+           INI_STOP_ON_FIRST_ERROR, INI_CALL_HANDLER_ON_NEW_SECTION);
+
+    for (const Case& c : cases())
+    {
+        for (bool reject_v : {false, true})
+        {
+            std::string expected;
+            std::string got;
+            int expected_error = c_parse(c.text, reject_v, &expected);
+            int error = template_parse(c.text, reject_v, &got);
+            if (got != expected || error != expected_error)
+            {
+                printf("%s%s: ini.c returned %d\n%sini.hpp returned %d\n%s", c.name,
+                       reject_v ? " (rejecting \"v\")" : "", expected_error, expected.c_str(), error, got.c_str());
+                check(false, "same entries and error line as ini.c");
+            }
+        }
+    }
+
+    // A void callback never makes an error of its own
+    int count = 0;
+    check(ini::parse("[s]\nk = v\n", [&count](const ini::entry&) { count++; }) == 0 &&
+          count == 1 + INI_CALL_HANDLER_ON_NEW_SECTION, "void callback");
+
+    printf("test_ini_template: OK\n");
+    return 0;
+}
@@ -17,4 +17,262 @@ target("test_ini_callback")
     add_rpathdirs("$ORIGIN") 
     add_ldflags("-fPIC") 
     add_deps("ini")  
-    add_links("ini") 
\ No newline at end of file
+    add_links("ini") 
+
+target("bench_ini_scan")
+    set_kind("binary")
+    add_files("bench_ini_scan.c")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+-- test_ini_template_<n>: ini.hpp against ini.c, both built with the dialect
+-- options set to the bits of n (bit 0 = the first option below)
+local template_options = {"INI_ALLOW_MULTILINE", "INI_ALLOW_BOM", "INI_ALLOW_INLINE_COMMENTS",
+                          "INI_ALLOW_NO_VALUE", "INI_STOP_ON_FIRST_ERROR", "INI_CALL_HANDLER_ON_NEW_SECTION"}
+local template_combinations = 1
+for _ = 1, #template_options do
+    template_combinations = template_combinations * 2
+end
+for n = 0, template_combinations - 1 do
+target("test_ini_template_" .. n)
+    set_kind("binary")
+    add_files("test_ini_template.cpp", "../../open_src/ini/ini.c")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    local bits = n
+    for _, option in ipairs(template_options) do
+        add_defines(option .. (bits % 2 == 1 and "=1" or "=0"))
+        bits = math.floor(bits / 2)
+    end
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+end
+
+
+target("test_ini_bind")
+    set_kind("binary")
+    add_files("test_ini_bind.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("test_ini_cache")
+    set_kind("binary")
+    add_files("test_ini_cache.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+-- The ini library with per-key access counting, for test_ini_access
+target("ini_stats")
+    set_kind("shared")
+    add_files("../../open_src/ini/ini.c", "../../open_src/ini/INIReader.cpp", "../../open_src/ini/INICache.cpp",
+              "../../open_src/ini/ConfigSnapshot.cpp", "../../open_src/ini/INILayeredReader.cpp")
+    add_includedirs("../../include")
+    add_defines("INI_READER_STATS=1")
+    add_cxflags("-g")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+
+target("test_ini_access")
+    set_kind("binary")
+    add_files("test_ini_access.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini_stats")  
+    add_links("ini_stats") 
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+
+target("test_ini_handle")
+    set_kind("binary")
+    add_files("test_ini_handle.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("test_ini_lazy")
+    set_kind("binary")
+    add_files("test_ini_lazy.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+
+target("test_ini_adopt")
+    set_kind("binary")
+    add_files("test_ini_adopt.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("test_ini_getall")
+    set_kind("binary")
+    add_files("test_ini_getall.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("test_ini_getmany")
+    set_kind("binary")
+    add_files("test_ini_getmany.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("test_ini_layered")
+    set_kind("binary")
+    add_files("test_ini_layered.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("test_ini_snapshot")
+    set_kind("binary")
+    add_files("test_ini_snapshot.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
+
+
+target("bench_ini")
+    set_kind("binary")
+    add_files("bench_ini.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("bench_ini_lookup")
+    set_kind("binary")
+    add_files("bench_ini_lookup.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("bench_ini_layered")
+    set_kind("binary")
+    add_files("bench_ini_layered.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("bench_ini_batch")
+    set_kind("binary")
+    add_files("bench_ini_batch.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("bench_ini_numbers")
+    set_kind("binary")
+    add_files("bench_ini_numbers.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("bench_ini_lazy")
+    set_kind("binary")
+    add_files("bench_ini_lazy.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("bench_ini_repeated")
+    set_kind("binary")
+    add_files("bench_ini_repeated.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+
+
+target("bench_ini_reload")
+    set_kind("binary")
+    add_files("bench_ini_reload.cpp")
+    add_includedirs("../../include")  
+    add_cxflags("-g")
+    add_rpathdirs("$ORIGIN") 
+    add_ldflags("-fPIC") 
+    add_deps("ini")  
+    add_links("ini") 
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end
@@ -0,0 +1,140 @@
+// Immutable configuration snapshots and a lock-free publisher for them.
+
+// SPDX-License-Identifier: BSD-3-Clause
+
+// inih and INIReader are released under the New BSD license (see LICENSE.txt).
+// Go to the project home page for more info:
+//
+// https://github.com/benhoyt/inih
+
+#ifndef CONFIGSNAPSHOT_H
+#define CONFIGSNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "INIReader.h"
+
+// One parsed version of a configuration. A snapshot never changes once it
+// has been published, so any number of threads can read it at once (the
+// INIReader getters are const and thread-safe).
+//
+// ConfigPublisher deletes the snapshots it holds through a ConfigSnapshot
+// pointer, so the destructor is virtual and a subclass carrying derived
+// state of its own can be published too.
+class ConfigSnapshot : public INIReader
+{
+public:
+    // Same as the INIReader constructors.
+    INI_API explicit ConfigSnapshot(const std::string& filename);
+    INI_API explicit ConfigSnapshot(const char* buffer, size_t buffer_size);
+    virtual ~ConfigSnapshot() = default;
+
+    // Number assigned by ConfigPublisher::Publish(): 1 for the first
+    // snapshot a publisher publishes, 2 for the next, and so on. 0 if the
+    // snapshot hasn't been published.
+    uint64_t Version() const { return _version; }
+
+private:
+    friend class ConfigPublisher;
+    uint64_t _version;
+};
+
+// Holds the current ConfigSnapshot and swaps in new ones while other
+// threads read. Reading takes no lock and does no read-modify-write on
+// shared memory: each reading thread announces itself in its own
+// cache-line-sized slot, and a replaced snapshot is only deleted once no
+// thread that could still see it is reading (epoch-based reclamation).
+//
+//   ConfigPublisher config(std::make_unique<ConfigSnapshot>("app.ini"));
+//   ...
+//   {
+//       ConfigPublisher::ReadGuard snapshot = config.Read();
+//       long port = snapshot->GetInteger("server", "port", 80);
+//   }
+//   ...
+//   config.Reload("app.ini");  // On another thread
+//
+// Keep a ReadGuard only for as long as the values are being read: while
+// it's alive, snapshots replaced after it was taken can't be freed.
+class ConfigPublisher
+{
+public:
+    // Reader slot of one thread; see ConfigSnapshot.cpp
+    struct ReaderSlot;
+
+    // Access to the snapshot that was current when Read() was called. It
+    // stays valid, and unchanged, until the guard is destroyed. Guards may
+    // be nested, but must be destroyed on the thread that took them.
+    class ReadGuard
+    {
+    public:
+        ReadGuard(ReadGuard&& other) noexcept : _slot(other._slot), _snapshot(other._snapshot)
+        {
+            other._slot = nullptr;
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+        ~ReadGuard() { if (_slot) Leave(_slot); }
+
+        // Null if nothing has been published yet.
+        const ConfigSnapshot* get() const { return _snapshot; }
+        const ConfigSnapshot* operator->() const { return _snapshot; }
+        const ConfigSnapshot& operator*() const { return *_snapshot; }
+        explicit operator bool() const { return _snapshot != nullptr; }
+
+    private:
+        friend class ConfigPublisher;
+        ReadGuard(ReaderSlot* slot, const ConfigSnapshot* snapshot) : _slot(slot), _snapshot(snapshot) {}
+        ReaderSlot* _slot;
+        const ConfigSnapshot* _snapshot;
+    };
+
+    INI_API explicit ConfigPublisher(std::unique_ptr<ConfigSnapshot> initial = nullptr);
+
+    // Deletes the current snapshot and any replaced ones not yet freed. No
+    // thread may be reading from the publisher.
+    INI_API ~ConfigPublisher();
+
+    ConfigPublisher(const ConfigPublisher&) = delete;
+    ConfigPublisher& operator=(const ConfigPublisher&) = delete;
+
+    // Start reading the current snapshot. Wait-free once the calling thread
+    // has a reader slot (the first Read() on a thread registers one).
+    INI_API ReadGuard Read() const;
+
+    // Make next the current snapshot and assign it the next version number.
+    // The replaced snapshot is deleted once no reader can still be using
+    // it, at this or a later Publish() or Reclaim(). Writers are serialized
+    // with each other but never wait for readers. A null next is ignored: the
+    // current snapshot and version stay as they are.
+    INI_API void Publish(std::unique_ptr<ConfigSnapshot> next);
+
+    // Parse filename into a new snapshot and publish it if it parsed without
+    // error. Return the snapshot's ParseError().
+    INI_API int Reload(const std::string& filename);
+
+    // Delete the replaced snapshots no reader can still be using. Return
+    // how many are still waiting for readers to finish.
+    INI_API size_t Reclaim();
+
+    // Version of the current snapshot, 0 if none has been published.
+    INI_API uint64_t Version() const;
+
+private:
+    static void Leave(ReaderSlot* slot);
+    size_t FreeRetired();
+
+    std::atomic<const ConfigSnapshot*> _current;
+    std::mutex _write_mutex;    // Serializes Publish() and Reclaim()
+    uint64_t _version;
+    // Replaced snapshots and the epoch at which they were replaced
+    std::vector<std::pair<const ConfigSnapshot*, uint64_t>> _retired;
+};
+
+#endif  // CONFIGSNAPSHOT_H
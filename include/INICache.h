@@ -0,0 +1,109 @@
+// Read an INI file through a compiled binary cache of its name/value pairs.
+
+// SPDX-License-Identifier: BSD-3-Clause
+
+// inih and INIReader are released under the New BSD license (see LICENSE.txt).
+// Go to the project home page for more info:
+//
+// https://github.com/benhoyt/inih
+
+#ifndef INICACHE_H
+#define INICACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "INIReader.h"  // INI_API
+
+// Read-only view of an INI file backed by a compiled image. After a
+// successful parse the image is written next to the source file; later
+// instances map it and serve lookups straight from the mapping, as long as
+// the source's size, mtime and content hash still match. Results are the
+// same as INIReader's: keys and section names are case-insensitive, and
+// repeated keys and multiline values are joined with "\n".
+//
+// The image is position-independent (offsets only) and holds the entries,
+// the interned strings and a perfect-hash index, so constructing from a
+// valid cache does no parsing and lookups do no allocation.
+class INICache
+{
+public:
+    // Load filename, using the image at cache_filename (default: filename +
+    // ".cache") if it is still valid, otherwise parse filename and rewrite
+    // the image. Failing to write the image is not an error.
+    INI_API explicit INICache(const std::string& filename,
+                              const std::string& cache_filename = std::string());
+    INI_API ~INICache();
+
+    INICache(const INICache&) = delete;
+    INICache& operator=(const INICache&) = delete;
+
+    // Return the result of parsing, i.e., 0 on success, line number of first
+    // error on parse error, -1 on file open error, or -2 if no image could be
+    // built (out of memory, or more than 4 GiB of strings).
+    INI_API int ParseError() const;
+
+    // Return true if the values came from a valid cache file rather than from
+    // parsing the source.
+    INI_API bool FromCache() const;
+
+    // Get a string value, returning default_value if not found. The returned
+    // view points into the image and stays valid for the lifetime of this
+    // object; the value is always followed by a NUL byte.
+    INI_API std::string_view GetView(std::string_view section, std::string_view name,
+                                     std::string_view default_value) const;
+
+    // Same as the INIReader getters of the same name.
+    INI_API std::string Get(std::string_view section, std::string_view name,
+                    const std::string& default_value) const;
+    INI_API std::string GetString(std::string_view section, std::string_view name,
+                    const std::string& default_value) const;
+    INI_API long GetInteger(std::string_view section, std::string_view name, long default_value) const;
+    INI_API int64_t GetInteger64(std::string_view section, std::string_view name, int64_t default_value) const;
+    INI_API unsigned long GetUnsigned(std::string_view section, std::string_view name, unsigned long default_value) const;
+    INI_API uint64_t GetUnsigned64(std::string_view section, std::string_view name, uint64_t default_value) const;
+    INI_API double GetReal(std::string_view section, std::string_view name, double default_value) const;
+    INI_API bool GetBoolean(std::string_view section, std::string_view name, bool default_value) const;
+    INI_API std::vector<std::string> Sections() const;
+    INI_API std::vector<std::string> Keys(std::string_view section) const;
+    INI_API bool HasSection(std::string_view section) const;
+    INI_API bool HasValue(std::string_view section, std::string_view name) const;
+
+private:
+    struct Header;
+    struct Entry;
+    struct Section;
+    struct Layout;
+
+    int _error;
+    bool _from_cache;
+    const char* _image;         // Mapped cache file or _owned.data()
+    size_t _image_size;
+    void* _map;                 // Non-null if _image is an mmap of the cache file
+    std::vector<uint64_t> _owned;  // Image built in memory (8-byte aligned)
+
+    // Tables inside _image, set by Attach()
+    const Header* _header;
+    const Entry* _entries;
+    const Section* _sections;
+    const uint32_t* _disp;
+    const uint32_t* _slots;
+    const char* _pool;
+
+    void Attach();
+    void Release();
+    const Entry* Find(std::string_view section, std::string_view name) const;
+    const Section* FindSection(std::string_view section) const;
+    const char* ValueOf(const Entry* e) const;
+    template <class T, class Parse>
+    T Typed(std::string_view section, std::string_view name, T default_value, Parse parse) const;
+    bool LoadCache(const std::string& cache_filename, uint64_t size, int64_t mtime);
+    bool CheckTables() const;
+    void Build(const char* data, size_t size, int64_t mtime, uint64_t hash);
+    void WriteCache(const std::string& cache_filename) const;
+};
+
+#endif  // INICACHE_H
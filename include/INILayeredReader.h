@@ -0,0 +1,81 @@
+// Read several INI sources, such as defaults, site, host and override
+// files, into one index.
+
+// SPDX-License-Identifier: BSD-3-Clause
+
+// inih and INIReader are released under the New BSD license (see LICENSE.txt).
+// Go to the project home page for more info:
+//
+// https://github.com/benhoyt/inih
+
+#ifndef INILAYEREDREADER_H
+#define INILAYEREDREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "INIReader.h"
+
+// An INIReader over several layers of configuration, lowest precedence
+// first. Where two layers set the same key, the later one's value replaces
+// the earlier one's; within one layer, repeated keys and multiline values
+// are joined as usual. Precedence is resolved while the layers are parsed,
+// so a lookup is a single probe of one index however many layers there
+// are, and every INIReader getter works unchanged.
+//
+//   INILayeredReader config({INILayeredReader::Source::File("defaults.ini"),
+//                            INILayeredReader::Source::File("/etc/app/site.ini"),
+//                            INILayeredReader::Source::Text(overrides)});
+//   long port = config.GetInteger("server", "port", 80);
+//   int from = config.Layer("server", "port");  // 0, 1, 2 or -1
+//
+// INIReader has no virtual destructor, so an INILayeredReader must not be
+// deleted through an INIReader pointer; own it as an INILayeredReader and
+// pass it to code taking a const INIReader& as needed.
+class INILayeredReader final : public INIReader
+{
+public:
+    // One layer: a file, or text in memory that only needs to stay alive
+    // while the reader is being built.
+    struct Source
+    {
+        static Source File(std::string filename) { return Source{std::move(filename), std::string_view(), true}; }
+        static Source Text(std::string_view text) { return Source{std::string(), text, false}; }
+
+        std::string filename;
+        std::string_view text;
+        bool is_file;
+    };
+
+    // Parse each source in turn. ParseError() is the first non-zero
+    // LayerError(), so a missing optional file shows up there as -1; check
+    // LayerError() to tell the layers apart.
+    INI_API explicit INILayeredReader(const std::vector<Source>& sources);
+
+    // Same as above, with a file for each layer.
+    INI_API explicit INILayeredReader(const std::vector<std::string>& filenames);
+
+    // Index of the layer the value of a key came from, or -1 if no layer
+    // sets it.
+    INI_API int Layer(std::string_view section, std::string_view name) const;
+    INI_API int Layer(Handle key) const;
+
+    size_t LayerCount() const { return _layer_errors.size(); }
+
+    // ParseError() of one layer on its own: 0 on success, line number of
+    // the first error, or -1 if the file couldn't be opened.
+    int LayerError(size_t layer) const { return _layer_errors[layer]; }
+
+private:
+    void Parse(const std::vector<Source>& sources);
+    static int LayerHandler(void* user, const ini_entry* entry);
+
+    std::vector<uint32_t> _layers;      // Per entry, parallel to _entries
+    std::vector<int> _layer_errors;
+    uint32_t _current;                  // Layer being parsed
+};
+
+#endif  // INILAYEREDREADER_H
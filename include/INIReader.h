@@ -12,11 +12,14 @@
 #ifndef INIREADER_H
 #define INIREADER_H
 
-#include <map>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <vector>
-#include <set>
 
 // Visibility symbols, required for Windows DLLs
 #ifndef INI_API
@@ -39,8 +42,17 @@
 #endif
 #endif
 
-// Read an INI file into easy-to-access name/value pairs. (Note that I've gone
-// for simplicity here rather than speed, but it should be pretty decent.)
+// Set to 1 when building the library to count how each key is read; see
+// AccessReport(). At 0 the getters carry no counting code.
+#ifndef INI_READER_STATS
+#define INI_READER_STATS 0
+#endif
+
+struct ini_entry;
+
+// Read an INI file into easy-to-access name/value pairs. Strings are kept in
+// one arena behind a flat hash index, so lookups don't allocate, and typed
+// values are parsed once and cached.
 class INIReader
 {
 public:
@@ -52,64 +64,604 @@ public:
     // about the parsing.
     INI_API explicit INIReader(const char *buffer, size_t buffer_size);
 
+    // How much the constructor copies. kEager copies every section, name
+    // and value into the reader. kLazy copies only section names and names:
+    // values are kept as offsets into the source text and copied out (with
+    // the lines of a multi-line or repeated key joined) the first time they
+    // are read. A kLazy reader builds faster and holds only its index plus
+    // the values read so far, at the price of a slower first read of each
+    // value. The getters stay const and thread-safe in both modes.
+    enum class Mode { kEager, kLazy };
+
+    // Parse filename. In kLazy mode the file is mapped (or read, where
+    // INI_USE_MMAP is 0) and kept for the lifetime of the reader, and values
+    // are read from the mapping. The file must therefore not be truncated
+    // or rewritten in place while the reader or a copy of it is alive:
+    // reading a value from a page past the new end of the file raises
+    // SIGBUS, and a rewrite may change values already indexed. Replace such
+    // a file by writing a new one and rename()-ing it over the old name,
+    // which leaves the mapped file untouched; otherwise use kEager, or read
+    // the file yourself and adopt the text (see kAdopt).
+    INI_API INIReader(const std::string& filename, Mode mode);
+
+    // Parse buffer. In kLazy mode the buffer is not copied and must outlive
+    // the reader and any copy of it.
+    INI_API INIReader(const char *buffer, size_t buffer_size, Mode mode);
+
+    // Tag for the constructors that take over the caller's text:
+    //   INIReader reader(INIReader::kAdopt, std::move(text));
+    // (A plain std::string&& overload would turn INIReader(path + ".ini")
+    // into parsing the file name.)
+    struct AdoptTag {};
+    static constexpr AdoptTag kAdopt{};
+
+    // Parse text and keep it in the reader instead of copying out of it.
+    // The reader is built as in kLazy mode, then single-line values are
+    // NUL-terminated where they are, so reading them never copies; only
+    // multi-line and repeated keys are joined into a copy on first read.
+    INI_API INIReader(AdoptTag, std::string&& text);
+    INI_API INIReader(AdoptTag, std::vector<char>&& text);
+
+    // Moving a reader moves its tables and never copies a string, so
+    // readers can be handed between threads and kept in containers cheaply.
+    // Views obtained from a reader stay valid when it is moved from, as
+    // long as the reader it was moved into lives. Copying is a deep copy
+    // of the tables (an adopted or mapped source is shared).
+    INIReader(INIReader&&) noexcept = default;
+    INIReader& operator=(INIReader&&) noexcept = default;
+    INIReader(const INIReader&) = default;
+    INIReader& operator=(const INIReader&) = default;
+
     // Return the result of ini_parse(), i.e., 0 on success, line number of
     // first error on parse error, or -1 on file open error.
     INI_API int ParseError() const;
 
+    // Lookups take std::string_view and hash the section and name in place,
+    // so passing a string literal or std::string doesn't build a key string.
+
     // Get a string value from INI file, returning default_value if not found.
-    INI_API std::string Get(const std::string& section, const std::string& name,
+    INI_API std::string Get(std::string_view section, std::string_view name,
                     const std::string& default_value) const;
 
+    // Get a string value from INI file without copying it, returning
+    // default_value if not found. The view points into the reader and stays
+    // valid until the reader is destroyed; the value is NUL-terminated.
+    INI_API std::string_view GetView(std::string_view section, std::string_view name,
+                    std::string_view default_value) const;
+
     // Get a string value from INI file, returning default_value if not found,
     // empty, or contains only whitespace.
-    INI_API std::string GetString(const std::string& section, const std::string& name,
+    INI_API std::string GetString(std::string_view section, std::string_view name,
                     const std::string& default_value) const;
 
+    // The typed getters below convert a value the first time it is read and
+    // cache the result in the reader, so reading a key again as the same
+    // type doesn't parse it again. Only the first type a key is read as is
+    // cached: a key read both as an integer and as a boolean, say, is parsed
+    // again on every read as the second type.
+
     // Get an integer (long) value from INI file, returning default_value if
     // not found or not a valid integer (decimal "1234", "-1234", or hex "0x4d2").
-    INI_API long GetInteger(const std::string& section, const std::string& name, long default_value) const;
+    INI_API long GetInteger(std::string_view section, std::string_view name, long default_value) const;
 
     // Get a 64-bit integer (int64_t) value from INI file, returning default_value if
     // not found or not a valid integer (decimal "1234", "-1234", or hex "0x4d2").
-    INI_API int64_t GetInteger64(const std::string& section, const std::string& name, int64_t default_value) const;
+    INI_API int64_t GetInteger64(std::string_view section, std::string_view name, int64_t default_value) const;
 
     // Get an unsigned integer (unsigned long) value from INI file, returning default_value if
     // not found or not a valid unsigned integer (decimal "1234", or hex "0x4d2").
-    INI_API unsigned long GetUnsigned(const std::string& section, const std::string& name, unsigned long default_value) const;
+    INI_API unsigned long GetUnsigned(std::string_view section, std::string_view name, unsigned long default_value) const;
 
     // Get an unsigned 64-bit integer (uint64_t) value from INI file, returning default_value if
     // not found or not a valid unsigned integer (decimal "1234", or hex "0x4d2").
-    INI_API uint64_t GetUnsigned64(const std::string& section, const std::string& name, uint64_t default_value) const;
+    INI_API uint64_t GetUnsigned64(std::string_view section, std::string_view name, uint64_t default_value) const;
 
     // Get a real (floating point double) value from INI file, returning
     // default_value if not found or not a valid floating point value
     // according to strtod().
-    INI_API double GetReal(const std::string& section, const std::string& name, double default_value) const;
+    INI_API double GetReal(std::string_view section, std::string_view name, double default_value) const;
 
     // Get a boolean value from INI file, returning default_value if not found or if
     // not a valid true/false value. Valid true values are "true", "yes", "on", "1",
     // and valid false values are "false", "no", "off", "0" (not case sensitive).
-    INI_API bool GetBoolean(const std::string& section, const std::string& name, bool default_value) const;
+    INI_API bool GetBoolean(std::string_view section, std::string_view name, bool default_value) const;
 
-    // Return a newly-allocated vector of all section names, in alphabetical order.
+    // Return a newly-allocated vector of all section names, in alphabetical
+    // order. SectionNames() lists them without copying.
     INI_API std::vector<std::string> Sections() const;
 
-    // Return a newly-allocated vector of keys in the given section, in alphabetical order.
-    INI_API std::vector<std::string> Keys(const std::string& section) const;
+    // Return a newly-allocated vector of keys in the given section, in
+    // alphabetical order. Items() lists them without copying.
+    INI_API std::vector<std::string> Keys(std::string_view section) const;
 
     // Return true if the given section exists (section must contain at least
     // one name=value pair).
-    INI_API bool HasSection(const std::string& section) const;
+    INI_API bool HasSection(std::string_view section) const;
 
     // Return true if a value exists with the given section and field names.
-    INI_API bool HasValue(const std::string& section, const std::string& name) const;
+    INI_API bool HasValue(std::string_view section, std::string_view name) const;
+
+    // Pre-resolved key returned by Resolve(). Reading through a handle
+    // indexes the value directly, with no hashing or string comparison. A
+    // handle stays valid for the lifetime of the reader that returned it and
+    // must not be used with any other reader.
+    class Handle
+    {
+    public:
+        Handle() : _index(UINT32_MAX) {}
+
+        // False if the key wasn't found when the handle was resolved.
+        explicit operator bool() const { return _index != UINT32_MAX; }
+
+    private:
+        friend class INIReader;
+        explicit Handle(uint32_t index) : _index(index) {}
+        uint32_t _index;
+    };
+
+    // Resolve section and name once for repeated reads. If the key doesn't
+    // exist the handle is empty, and reads through it return default_value.
+    INI_API Handle Resolve(std::string_view section, std::string_view name) const;
+
+    // Same as the getters above, for a key resolved in advance.
+    INI_API std::string Get(Handle key, const std::string& default_value) const;
+    INI_API std::string_view GetView(Handle key, std::string_view default_value) const;
+    INI_API std::string GetString(Handle key, const std::string& default_value) const;
+    INI_API long GetInteger(Handle key, long default_value) const;
+    INI_API int64_t GetInteger64(Handle key, int64_t default_value) const;
+    INI_API unsigned long GetUnsigned(Handle key, unsigned long default_value) const;
+    INI_API uint64_t GetUnsigned64(Handle key, uint64_t default_value) const;
+    INI_API double GetReal(Handle key, double default_value) const;
+    INI_API bool GetBoolean(Handle key, bool default_value) const;
+    INI_API bool HasValue(Handle key) const;
+
+    // One key for GetMany(), and the type to read its value as. kString
+    // reads it like GetView(), the others like GetInteger64(),
+    // GetUnsigned64(), GetReal() and GetBoolean().
+    struct KeyRequest
+    {
+        enum Type { kString, kInteger, kUnsigned, kReal, kBoolean };
+
+        std::string_view section;
+        std::string_view name;
+        Type type;
+    };
+
+    // The value read for a KeyRequest. Set the default in the member for
+    // the request's type before calling GetMany(); it is replaced only if
+    // the key exists and its value is valid for the type. The other value
+    // members are left alone.
+    struct Result
+    {
+        bool found;             // Set by GetMany()
+        std::string_view string;
+        int64_t integer;
+        uint64_t unsigned_integer;
+        double real;
+        bool boolean;
+    };
+
+    // Read count keys in one pass, as when a program loads its settings at
+    // startup: all the keys are hashed first and their hash slots and
+    // entries prefetched, so the cache misses of the lookups overlap instead
+    // of being paid one after another. results[i] is filled for
+    // requests[i].
+    INI_API void GetMany(const KeyRequest* requests, Result* results, size_t count) const;
+
+    // The values of one key, in file order. A key given several times, or
+    // continued over several lines, has one value per line, which Get()
+    // joins with "\n". Get() only puts a "\n" after text, as inih always
+    // has, so empty lines at the start are dropped from it: for the lines
+    // "" and "a", Get() is "a" while joining the range gives "\na".
+    // Returned by GetAll(); the views point into the reader
+    // (or the text a kLazy reader indexes), so nothing is copied, and they
+    // stay valid for the reader's lifetime. They aren't necessarily
+    // NUL-terminated.
+    class ValueRange
+    {
+    public:
+        class iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::string_view value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const std::string_view* pointer;
+            typedef std::string_view reference;
+
+            iterator() : _reader(nullptr), _index(0), _piece(0) {}
+            std::string_view operator*() const
+            {
+                if (_piece == kOwn)
+                {
+                    const Entry& entry = _reader->_entries[_index];
+                    return _reader->PieceText(entry.value, entry.value_size);
+                }
+                const Piece& piece = _reader->_pieces[_piece - 1];
+                return _reader->PieceText(piece.offset, piece.size);
+            }
+            iterator& operator++()
+            {
+                _piece = _piece == kOwn ? 0 : _reader->_pieces[_piece - 1].next;
+                return *this;
+            }
+            iterator operator++(int) { iterator old = *this; ++*this; return old; }
+            bool operator==(const iterator& other) const { return _piece == other._piece; }
+            bool operator!=(const iterator& other) const { return _piece != other._piece; }
+
+        private:
+            friend class ValueRange;
+            static const uint32_t kOwn = UINT32_MAX;  // The entry's one value
+            iterator(const INIReader* reader, uint32_t index, uint32_t piece)
+                : _reader(reader), _index(index), _piece(piece) {}
+            const INIReader* _reader;
+            uint32_t _index;
+            uint32_t _piece;    // Index + 1 into _pieces, 0 at the end
+        };
+
+        ValueRange() : _reader(nullptr), _index(UINT32_MAX) {}
+        iterator begin() const
+        {
+            if (_index == UINT32_MAX)
+                return end();
+            const Entry& entry = _reader->_entries[_index];
+            return iterator(_reader, _index, entry.multi ? _reader->_multi[entry.value].first_piece : iterator::kOwn);
+        }
+        iterator end() const { return iterator(_reader, _index, 0); }
+        size_t size() const
+        {
+            if (_index == UINT32_MAX)
+                return 0;
+            const Entry& entry = _reader->_entries[_index];
+            return entry.multi ? _reader->_multi[entry.value].count : 1;
+        }
+        bool empty() const { return _index == UINT32_MAX; }
+
+    private:
+        friend class INIReader;
+        ValueRange(const INIReader* reader, uint32_t index) : _reader(reader), _index(index) {}
+        const INIReader* _reader;
+        uint32_t _index;        // Entry index, UINT32_MAX if the key wasn't found
+    };
+
+    // Return every value of the given key without copying or joining them.
+    // The range is empty if the key doesn't exist.
+    INI_API ValueRange GetAll(std::string_view section, std::string_view name) const;
+    INI_API ValueRange GetAll(Handle key) const;
+
+    // One name=value pair, as seen when iterating over the reader. Section
+    // and name are lower-cased; the views stay valid for the lifetime of the
+    // reader, and each is NUL-terminated.
+    struct Item
+    {
+        std::string_view section;
+        std::string_view name;
+        std::string_view value;
+    };
+
+    // Forward iterator over all name=value pairs, in the order their keys
+    // first appear in the file.
+    class const_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Item value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Item* pointer;
+        typedef Item reference;
+
+        const_iterator() : _reader(nullptr), _index(0) {}
+        Item operator*() const { return _reader->At(_index); }
+        const_iterator& operator++() { _index++; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; _index++; return old; }
+        bool operator==(const const_iterator& other) const { return _index == other._index; }
+        bool operator!=(const const_iterator& other) const { return _index != other._index; }
+
+    private:
+        friend class INIReader;
+        const_iterator(const INIReader* reader, size_t index) : _reader(reader), _index(index) {}
+        const INIReader* _reader;
+        size_t _index;
+    };
+
+    // The name=value pairs of one section, in the order their keys first
+    // appear in the file. Returned by Items(); it points into the reader and
+    // stays valid for the reader's lifetime.
+    class ItemRange
+    {
+    public:
+        class iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef Item value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Item* pointer;
+            typedef Item reference;
+
+            iterator() : _reader(nullptr), _pos(nullptr) {}
+            Item operator*() const { return _reader->At(*_pos); }
+            iterator& operator++() { _pos++; return *this; }
+            iterator operator++(int) { iterator old = *this; _pos++; return old; }
+            bool operator==(const iterator& other) const { return _pos == other._pos; }
+            bool operator!=(const iterator& other) const { return _pos != other._pos; }
+
+        private:
+            friend class ItemRange;
+            iterator(const INIReader* reader, const uint32_t* pos) : _reader(reader), _pos(pos) {}
+            const INIReader* _reader;
+            const uint32_t* _pos;
+        };
+
+        ItemRange() : _reader(nullptr), _first(nullptr), _size(0) {}
+        iterator begin() const { return iterator(_reader, _first); }
+        iterator end() const { return iterator(_reader, _first + _size); }
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+    private:
+        friend class INIReader;
+        ItemRange(const INIReader* reader, const uint32_t* first, size_t size)
+            : _reader(reader), _first(first), _size(size) {}
+        const INIReader* _reader;
+        const uint32_t* _first;
+        size_t _size;
+    };
+
+    // Return the name=value pairs of the given section, without copying
+    // anything. The range is empty if the section doesn't exist.
+    INI_API ItemRange Items(std::string_view section) const;
+
+    // Section names (lower-cased, NUL-terminated) in the order they first
+    // appear in the file, without copying them.
+    class SectionRange
+    {
+    public:
+        class iterator
+        {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::string_view value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const std::string_view* pointer;
+            typedef std::string_view reference;
+
+            iterator() : _reader(nullptr), _index(0) {}
+            std::string_view operator*() const
+            {
+                const Section& section = _reader->_sections[_index];
+                return _reader->Text(section.name, section.name_size);
+            }
+            iterator& operator++() { _index++; return *this; }
+            iterator operator++(int) { iterator old = *this; _index++; return old; }
+            bool operator==(const iterator& other) const { return _index == other._index; }
+            bool operator!=(const iterator& other) const { return _index != other._index; }
+
+        private:
+            friend class SectionRange;
+            iterator(const INIReader* reader, size_t index) : _reader(reader), _index(index) {}
+            const INIReader* _reader;
+            size_t _index;
+        };
+
+        iterator begin() const { return iterator(_reader, 0); }
+        iterator end() const { return iterator(_reader, _reader->_sections.size()); }
+        size_t size() const { return _reader->_sections.size(); }
+        bool empty() const { return _reader->_sections.empty(); }
+
+    private:
+        friend class INIReader;
+        explicit SectionRange(const INIReader* reader) : _reader(reader) {}
+        const INIReader* _reader;
+    };
+
+    SectionRange SectionNames() const { return SectionRange(this); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, _entries.size()); }
+
+    // Number of distinct name=value pairs.
+    size_t size() const { return _entries.size(); }
+
+    // Heap memory held by the reader, in bytes, and the number of heap blocks
+    // it is spread over.
+    struct MemoryStats
+    {
+        size_t strings;      // Section names, names and values (in kLazy
+                             // mode, only the values read so far)
+        size_t records;      // Per-entry and per-section records
+        size_t index;        // Hash tables and section directory
+        size_t total;
+        size_t allocations;
+    };
+
+    INI_API MemoryStats MemoryUsage() const;
+
+    // How one key was read, for finding hot keys, keys nothing reads and
+    // lookups that fell back to their default. A read is a getter, GetAll()
+    // or GetMany() request that found the key, or HasValue() on it; a
+    // lookup by name counts once per call, a Handle lookup once per read
+    // through it (a Handle that didn't resolve was counted as one miss).
+    struct KeyAccess
+    {
+        std::string section;    // Lower-cased
+        std::string name;
+        bool present;           // false for a key looked up but not in the file
+        uint64_t reads;
+        uint64_t misses;        // Lookups of a key that isn't there
+        uint64_t fallbacks;     // Typed reads that returned the default
+                                // because the value didn't convert
+    };
+
+    // Every key in the file, plus every missing key that was looked up,
+    // busiest (reads + misses) first and then by section and name; keys
+    // never read come last. Copies of a reader share their counts. Empty
+    // unless the library was built with INI_READER_STATS.
+    INI_API std::vector<KeyAccess> AccessReport() const;
 
 protected:
+    // An empty reader, for subclasses that parse into it themselves and then
+    // call Finish()
+    INIReader() : _error(0), _lazy(false), _source(nullptr), _source_size(0) {}
+
+    // std::atomic that can be kept in a vector; copies start out zero, and
+    // are noexcept so that vectors of entries still move
+    template <class T>
+    struct CacheWord : std::atomic<T>
+    {
+        CacheWord() : std::atomic<T>(0) {}
+        CacheWord(const CacheWord&) noexcept : std::atomic<T>(0) {}
+        CacheWord& operator=(const CacheWord&) noexcept { this->store(0); return *this; }
+    };
+
+    // Bits of Entry::typed_flags. The typed form of a value is parsed the
+    // first time it is asked for. The getters are const and may run on
+    // several threads at once, so the cache is filled through atomics: the
+    // first thread to parse the value claims it with kBusy, stores the bits
+    // and then publishes the form's "parsed" bit (with a "valid" bit one
+    // above it). Only one form is kept; a value read as two different types
+    // parses the second one every time. kBusy has a bit of its own, so a
+    // claimed entry never looks parsed as any type.
+    enum : uint16_t { kInteger = 1, kUnsigned = 4, kReal = 16, kBoolean = 64, kBusy = 256 };
+
+    // One name=value pair. Strings live in _arena as offsets (NUL-terminated,
+    // section and name lower-cased); the section name is stored once, in
+    // _sections. A value given on several lines is an index into _multi
+    struct Entry
+    {
+        uint64_t hash;
+        uint32_t section;       // Index into _sections
+        uint32_t name;
+        uint32_t name_size;
+        uint32_t value;
+        uint32_t value_size;    // For a multi-line value, the joined size
+        mutable CacheWord<uint16_t> typed_flags;
+        uint8_t multi;          // value is an index into _multi
+        mutable CacheWord<uint64_t> typed_bits;
+    };
+
+    // A value given on several lines (a repeated key or continuation
+    // lines). Each line is a piece, chained in file order, and the joined
+    // form Get() returns is only built the first time it is asked for
+    struct MultiValue
+    {
+        uint32_t first_piece;   // Index + 1 into _pieces
+        uint32_t last_piece;
+        uint32_t count;
+        mutable CacheWord<const char*> joined;
+    };
+
+    struct Piece
+    {
+        uint32_t offset;        // As for PieceText()
+        uint32_t size;
+        uint32_t next;          // Index + 1 into _pieces, 0 at the end
+    };
+
+    // kLazy mode only, parallel to _entries: the NUL-terminated copy of a
+    // one-line value once it has been read
+    struct LazyValue
+    {
+        mutable CacheWord<const char*> data;
+    };
+
+    // Storage for joined values and values copied out of _source; see
+    // INIReader.cpp
+    struct ValueStore;
+
+    // Per-thread access counts for AccessReport(); see INIReader.cpp
+    struct AccessLog;
+
+    struct Section
+    {
+        uint64_t hash;
+        uint32_t name;
+        uint32_t name_size;
+        uint32_t first_key;     // This section's run in _section_keys
+        uint32_t key_count;
+    };
+    // Open-addressing slot: the high half of the hash, so most mismatches
+    // are rejected without touching the entry, and the entry index + 1
+    // (0 means empty)
+    struct Slot
+    {
+        uint32_t tag;
+        uint32_t index;
+    };
+
     int _error;
-    std::map<std::string, std::string> _values;
-    static std::string MakeKey(const std::string& section, const std::string& name);
-    static int ValueHandler(void* user, const char* section, const char* name,
-                            const char* value);
+    std::vector<char> _arena;         // All strings, back to back
+    std::vector<Entry> _entries;      // In order of first appearance
+    std::vector<Slot> _slots;         // Index over _entries, power-of-two size
+    std::vector<Section> _sections;   // Sections with at least one value
+    std::vector<Slot> _section_slots; // Index over _sections
+    std::vector<uint32_t> _section_keys;  // Entry indices grouped by section
+    std::vector<MultiValue> _multi;   // Values given on several lines
+    std::vector<Piece> _pieces;
+    std::shared_ptr<ValueStore> _store;   // Null until a value needs it
+    // kLazy mode: the text values point into, who owns it (null for a
+    // borrowed buffer), and the values copied out of it so far
+    bool _lazy;
+    const char* _source;
+    size_t _source_size;
+    std::shared_ptr<const char> _source_owner;
+    std::vector<LazyValue> _lazy_values;
+    std::shared_ptr<AccessLog> _access;   // Null unless INI_READER_STATS
+
+    const Entry* Find(std::string_view section, std::string_view name) const;
+    const Entry* Find(std::string_view section, std::string_view name, uint64_t hash) const;
+    const Entry* Find(Handle key) const;
+    const Section* FindSection(std::string_view section) const;
+    std::string_view Text(uint32_t offset, uint32_t size) const
+    {
+        return std::string_view(_arena.data() + offset, size);
+    }
+    Item At(size_t index) const
+    {
+        const Entry& entry = _entries[index];
+        const Section& section = _sections[entry.section];
+        return Item{Text(section.name, section.name_size), Text(entry.name, entry.name_size),
+                    Value(entry)};
+    }
+    std::string_view Value(const Entry& entry) const
+    {
+        if (entry.multi)
+            return std::string_view(Joined(entry), entry.value_size);
+        if (!_lazy)
+            return Text(entry.value, entry.value_size);
+        const LazyValue& lazy = _lazy_values[&entry - _entries.data()];
+        const char* data = lazy.data.load(std::memory_order_acquire);
+        return std::string_view(data ? data : Materialize(entry), entry.value_size);
+    }
+    // One line of a value where it is stored. In kLazy mode, offsets past
+    // the end of _source are in _arena: the parser copies the last line of
+    // text when it has no line break, so that value has to be copied too
+    std::string_view PieceText(uint32_t offset, uint32_t size) const
+    {
+        if (!_lazy)
+            return Text(offset, size);
+        if (offset < _source_size)
+            return std::string_view(_source + offset, size);
+        return Text(static_cast<uint32_t>(offset - _source_size), size);
+    }
+    INI_API const char* Joined(const Entry& entry) const;
+    INI_API const char* Materialize(const Entry& entry) const;
+    void Load(const char* buffer, size_t buffer_size, Mode mode);
+    void Adopt(char* text, size_t size);
+    void AddPiece(Entry& stored, uint32_t offset, uint32_t size);
+    uint32_t Intern(std::string_view text, bool lower);
+    template <class T, class Parse>
+    static bool Cached(const Entry& entry, uint16_t parsed, T* out, Parse parse);
+    bool ReadTyped(const Entry& entry, int64_t* out) const;
+    bool ReadTyped(const Entry& entry, uint64_t* out) const;
+    bool ReadTyped(const Entry& entry, double* out) const;
+    bool ReadTyped(const Entry& entry, bool* out) const;
+    void Finish();
+    // Count a read of entry (converted is false when a typed read fell back
+    // to its default) and return converted, or count a miss
+    bool Counted(const Entry& entry, bool converted) const;
+    void CountMiss(std::string_view section, std::string_view name) const;
+    static int ValueHandler(void* user, const ini_entry* entry);
 };
 
 #endif  // INIREADER_H
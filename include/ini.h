@@ -102,6 +102,36 @@ typedef int (*ini_handler)(void* user, const char* section,
                            const char* name, const char* value);
 #endif
 
+/**
+ * @struct ini_entry
+ * @brief 传给ini_handler_ex的条目，所有字符串都附带长度
+ * 
+ * 与ini_handler不同，这里的字符串不保证以NUL结尾，必须按长度读取。
+ * 消费者可以直接据此构造string_view，省去strlen与拷贝。
+ * 
+ * @remarks 
+ *   - 指针指向解析器内部缓冲区或被解析的输入本身，回调返回后可能失效
+ *   - 新节回调（INI_CALL_HANDLER_ON_NEW_SECTION）中name为NULL；
+ *     无值键（INI_ALLOW_NO_VALUE）中value为NULL，对应长度为0
+ */
+typedef struct ini_entry
+{
+    const char* section;  // 节名（未指定节时为空串）
+    size_t section_len;
+    const char* name;     // 键名
+    size_t name_len;
+    const char* value;    // 键值
+    size_t value_len;
+    int lineno;           // 所在行号（从1开始）
+    size_t offset;        // 所在行行首在输入中的字节偏移
+} ini_entry;
+
+/**
+ * @typedef ini_handler_ex
+ * @brief 携带长度、行号和字节偏移的回调函数原型，返回值约定同ini_handler
+ */
+typedef int (*ini_handler_ex)(void* user, const ini_entry* entry);
+
 /* Typedef for fgets样式读取器的函数. */
 typedef char* (*ini_reader)(char* str, int num, void* stream);
 
@@ -118,7 +148,7 @@ typedef char* (*ini_reader)(char* str, int num, void* stream);
  * @param user: 传递用户自定义数据指针, 用户可以在回调函数handler内访问自己的数据，从而实现数据的传递。
  * @details: 
  *    - 值会删除空格
- *    - 会忽略ini文件的';'，注意：当 INI_USE_STACK 定义为 0 时才会发生内存分配错误 (-2)
+ *    - 会忽略ini文件的';'，注意：只有块缓冲区分配失败时才会发生内存分配错误 (-2)
  *    - 支持 [section] 格式，支持 name=value 和 name:value 两种赋值语法
  *    - 空行和以 ';' 开头的行将被忽略，section 名称默认为空字符串。
  *    - 回调函数返回 0 时会记录错误行号，但解析会继续直到文件结束（除非 INI_STOP_ON_FIRST_ERROR 被定义）
@@ -132,6 +162,9 @@ INI_API int ini_parse(const char* filename, ini_handler handler, void* user);
  * 
  * 功能与ini_parse()相同，但直接操作FILE*流而非文件名。
  * 解析完成后不会关闭文件，需调用者自行处理。
+ * 文件按64KiB的块fread读入，块内用memchr切分行，不再逐行调用fgets。
+ * 因此返回后流的读取位置未指定：解析提前结束时（如INI_STOP_ON_FIRST_ERROR），
+ * 流可能已被读到停止行之后至多一个块（64KiB）的位置，调用者不应在返回后继续从中读取。
  * 
  * @param file 已打开的INI文件流
  * @param handler 回调处理函数
@@ -139,7 +172,7 @@ INI_API int ini_parse(const char* filename, ini_handler handler, void* user);
  * @return 
  *   - 0：解析成功
  *   - -1：读取文件失败
- *   - -2：内存分配错误（仅当INI_USE_STACK为0时）
+ *   - -2：内存分配错误（块缓冲区分配失败）
  *   - >0：首条错误所在行号
  */
 INI_API int ini_parse_file(FILE* file, ini_handler handler, void* user);
@@ -197,6 +230,8 @@ INI_API int ini_parse_string(const char* string, ini_handler handler, void* user
  * 
  * 功能与ini_parse_string()相同，但直接指定字符串长度而不依赖NULL终止符，
  * 避免调用strlen()，适用于处理非NULL终止的内存块（如网络数据）。
+ * 行尾通过memchr查找，每行只拷贝一次（输入不可写，需要拷贝后才能写入NUL结束符）；
+ * 不需要拷贝时请使用ini_parse_string_inplace()或ini_parse_string_length_ex()。
  * 
  * @param string 包含INI配置的字符串
  * @param length 字符串长度（字节数）
@@ -211,6 +246,116 @@ INI_API int ini_parse_string_length(const char* string, size_t length, ini_handl
 
 
 
+/**
+ * @brief 就地解析可写的内存缓冲区
+ * 
+ * 功能与ini_parse_string_length()相同，但解析器直接在string上写入NUL结束符，
+ * handler收到的section/name/value指向string本身，整个过程不拷贝任何字节
+ * （唯一的例外是末尾没有换行符的最后一行，它会被拷贝到栈上）。
+ * 
+ * @param string 可写的INI数据，解析后内容被修改
+ * @param length 数据长度（字节数）
+ * @param handler 回调处理函数
+ * @param user 传递给回调函数的用户数据
+ * @return 
+ *   - 0：解析成功
+ *   - >0：首条错误所在行号
+ */
+INI_API int ini_parse_string_inplace(char* string, size_t length, ini_handler handler, void* user);
+
+
+
+/**
+ * @brief 将INI文件映射到内存后就地解析
+ * 
+ * 功能与ini_parse()相同，但不经过stdio和行缓冲区：文件通过mmap映射
+ * （MAP_PRIVATE，写时复制），解析器用memchr在映射上直接切分行，
+ * handler收到的section/name/value均指向映射内的内存。
+ * 启动耗时只取决于缺页次数，适合数百MB的大文件。
+ * 
+ * @param filename 文件名
+ * @param handler 回调处理函数
+ * @param user 传递给回调函数的用户数据
+ * @return 
+ *   - 0：解析成功
+ *   - -1：打开或stat文件失败
+ *   - -2：mmap失败
+ *   - >0：首条错误所在行号
+ * @note 映射在函数返回前解除，handler不能在返回后继续持有这些指针；
+ *       若INI_USE_MMAP为0，则退化为ini_parse()
+ */
+INI_API int ini_parse_mmap(const char* filename, ini_handler handler, void* user);
+
+
+
+/**
+ * @brief 多线程解析大块内存中的INI数据
+ * 
+ * 在位于行首的[section]行处把缓冲区切成约INI_PARALLEL_CHUNK（默认1MiB）的分块，
+ * 由最多threads个工作线程并行解析，主线程再按原始文件顺序把条目交给handler。
+ * 每个这样的节行都会重置当前节和多行状态，因此结果（包括多行续行、错误行号、
+ * INI_STOP_ON_FIRST_ERROR）与串行解析完全一致；handler只在调用线程中被调用。
+ * 
+ * ini_parse_parallel()像ini_parse_string_inplace()一样就地写入NUL结束符；
+ * ini_parse_parallel_ex()不修改缓冲区。
+ * 
+ * @param buffer INI数据
+ * @param length 数据长度（字节数）
+ * @param threads 工作线程数，<=0表示使用在线CPU数
+ * @param handler 回调处理函数
+ * @param user 传递给回调函数的用户数据
+ * @return 
+ *   - 0：解析成功
+ *   - -2：内存分配错误
+ *   - >0：首条错误所在行号
+ * @note 数据小于两个分块、threads为1或INI_USE_THREADS为0时退化为串行解析
+ */
+INI_API int ini_parse_parallel(char* buffer, size_t length, int threads,
+                               ini_handler handler, void* user);
+INI_API int ini_parse_parallel_ex(const char* buffer, size_t length, int threads,
+                                  ini_handler_ex handler, void* user);
+
+/**
+ * @brief 以ini_handler_ex回调解析INI数据的各个变体
+ * 
+ * 参数与返回值分别与去掉_ex后缀的同名函数相同，区别仅在于回调类型。
+ * 解析器不再为回调写入NUL结束符，因此：
+ *   - ini_parse_string_length_ex/ini_parse_string_ex直接在调用者的缓冲区上解析，零拷贝
+ *   - ini_parse_mmap_ex使用只读映射，不触发写时复制
+ */
+INI_API int ini_parse_ex(const char* filename, ini_handler_ex handler, void* user);
+INI_API int ini_parse_file_ex(FILE* file, ini_handler_ex handler, void* user);
+INI_API int ini_parse_stream_ex(ini_reader reader, void* stream, ini_handler_ex handler,
+                                void* user);
+INI_API int ini_parse_string_ex(const char* string, ini_handler_ex handler, void* user);
+INI_API int ini_parse_string_length_ex(const char* string, size_t length,
+                                       ini_handler_ex handler, void* user);
+INI_API int ini_parse_mmap_ex(const char* filename, ini_handler_ex handler, void* user);
+
+
+
+/**
+ * @brief 字符分类（空白、分隔符、注释前缀）所用的指令集级别
+ * 
+ * 解析器在每次解析开始时按此级别选择实现：
+ *   - INI_SIMD_SCALAR：逐字节的标量实现
+ *   - INI_SIMD_SSE2：一次分类16字节
+ *   - INI_SIMD_AVX2：一次分类32字节
+ * 各级别的解析结果逐字节一致。默认使用运行时检测到的CPU支持的最高级别。
+ * 
+ * @return ini_simd_level()返回当前级别；ini_set_simd_level()返回实际生效的级别
+ *         （超出CPU支持范围或非法的level会被替换为支持的最高级别）
+ * @note ini_set_simd_level()主要用于基准测试和对比验证，应在解析开始前调用
+ */
+#define INI_SIMD_SCALAR 0
+#define INI_SIMD_SSE2 1
+#define INI_SIMD_AVX2 2
+
+INI_API int ini_simd_level(void);
+INI_API int ini_set_simd_level(int level);
+
+
+
 /**
  * @def INI_ALLOW_MULTILINE
  * @brief 是否允许多行值解析（模仿Python configparser）
@@ -398,7 +543,8 @@ INI_API int ini_parse_string_length(const char* string, size_t length, ini_handl
  * 
  * 若为1，使用自定义的ini_malloc、ini_free和ini_realloc函数，
  * 需自行实现这些函数（签名需与标准malloc/free/realloc一致）。
- * 注意：必须同时将INI_USE_STACK设为0。
+ * ini_parse_file()的块缓冲区总是经由ini_malloc分配；行缓冲区只有在
+ * INI_USE_STACK为0时才使用ini_malloc。
  * 
  * 默认值：0（使用标准库函数）
  */
@@ -408,6 +554,166 @@ INI_API int ini_parse_string_length(const char* string, size_t length, ini_handl
 #endif
 
 
+
+/**
+ * @def INI_USE_MMAP
+ * @brief ini_parse_mmap()是否使用mmap映射文件
+ * 
+ * 若为1，ini_parse_mmap()通过mmap映射文件并就地解析；
+ * 若为0，ini_parse_mmap()等价于ini_parse()。
+ * 
+ * 默认值：POSIX平台为1，其他平台（如Windows）为0
+ */
+#ifndef INI_USE_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define INI_USE_MMAP 1
+#else
+#define INI_USE_MMAP 0
+#endif
+#endif
+
+
+/**
+ * @def INI_USE_THREADS
+ * @brief ini_parse_parallel()是否使用pthread工作线程
+ * 
+ * 若为0，ini_parse_parallel()在调用线程中串行解析。
+ * 
+ * 默认值：POSIX平台为1，其他平台为0
+ */
+#ifndef INI_USE_THREADS
+#if defined(__unix__) || defined(__APPLE__)
+#define INI_USE_THREADS 1
+#else
+#define INI_USE_THREADS 0
+#endif
+#endif
+
+
+/**
+ * @def INI_USE_SIMD
+ * @brief 是否编译SSE2/AVX2字符分类实现
+ * 
+ * 若为1，编译SSE2/AVX2版本并在运行时按CPU能力选择（见ini_simd_level()）；
+ * 若为0，只使用标量实现。
+ * 
+ * 默认值：x86/x86-64上的GCC/Clang为1，其他为0
+ */
+#ifndef INI_USE_SIMD
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define INI_USE_SIMD 1
+#else
+#define INI_USE_SIMD 0
+#endif
+#endif
+
+
+
+/**
+ * @def INI_MAX_SECTION
+ * @brief 节名的最大长度（含NUL），更长的节名会被截断
+ * 
+ * 默认值：50
+ */
+#ifndef INI_MAX_SECTION
+#define INI_MAX_SECTION 50
+#endif
+
+
+/**
+ * @def INI_MAX_NAME
+ * @brief 多行续行时所保存的键名的最大长度（含NUL），更长的键名会被截断
+ * 
+ * 默认值：50
+ */
+#ifndef INI_MAX_NAME
+#define INI_MAX_NAME 50
+#endif
+
+
+
+/**
+ * @struct ini_parse_state
+ * @brief 跨行保存的解析状态，所有ini_parse_*入口共用同一套逐行解析逻辑
+ * 
+ * 仅为了让调用者能够直接分配ini_parser而公开，字段不属于公开接口，不应直接访问。
+ */
+typedef struct ini_parse_state
+{
+    ini_handler handler;
+    ini_handler_ex handler_ex;
+    void* user;
+    const struct ini_scanner* scan;
+    // 当前节名。in_place为0时指向section_buf，否则可直接指向被解析的缓冲区
+    const char* section;
+    size_t section_len;
+    char section_buf[INI_MAX_SECTION];
+#if INI_ALLOW_MULTILINE
+    // 上一个键名，规则同section
+    const char* prev_name;
+    size_t prev_name_len;
+    char prev_name_buf[INI_MAX_NAME];
+#endif
+    // 为1表示行内存在整个解析期间保持有效（如mmap映射），节名和键名无需拷贝
+    int in_place;
+    // 为1表示需要就地写入NUL结束符（ini_handler）；ini_handler_ex按长度读取，不写入
+    int terminate;
+    int lineno;
+    // 当前行首在输入中的字节偏移
+    size_t offset;
+    int error;
+} ini_parse_state;
+
+/**
+ * @struct ini_parser
+ * @brief 推送式（push）解析器的状态
+ * 
+ * 块内完整的行直接解析，跨块的不完整行暂存在partial中。
+ * 由调用者分配（栈上或嵌入其他结构体），不需要释放，字段不应直接访问。
+ * 
+ * @note 结构体布局取决于INI_MAX_LINE等配置宏，使用者与库必须以相同的宏编译
+ */
+typedef struct ini_parser
+{
+    ini_parse_state st;
+    // 尚未遇到换行符的行，只保留前INI_MAX_LINE - 1字节（更长的部分反正会被截断）
+    char partial[INI_MAX_LINE];
+    size_t partial_len;     // partial中保存的字节数
+    size_t partial_total;   // 该行已收到的总字节数
+    size_t partial_offset;  // 该行行首的字节偏移
+    int has_partial;
+    size_t consumed;        // 已喂入的总字节数
+} ini_parser;
+
+
+/**
+ * @brief 推送式解析：数据到达多少就喂入多少，不在reader回调中阻塞
+ * 
+ * 适用于事件循环中从非阻塞管道/套接字接收配置的场景：
+ * @code
+ * ini_parser parser;
+ * ini_parser_init(&parser, handler, user);
+ * while ((n = read(fd, buf, sizeof(buf))) > 0)   // 或在可读事件中调用
+ *     ini_parser_feed(&parser, buf, n);
+ * error = ini_parser_finish(&parser);
+ * @endcode
+ * 
+ * 不完整的行、当前节名和多行状态在多次调用之间保存在parser中。
+ * 每个字节最多被拷贝一次：使用ini_handler_ex时块内完整的行直接在bytes上解析，
+ * 使用ini_handler时整行拷贝一次以写入NUL结束符；跨块的行只拷贝进partial一次。
+ * 
+ * - ini_parser_init/ini_parser_init_ex：初始化parser，分别使用ini_handler/ini_handler_ex
+ * - ini_parser_feed：喂入bytes的n个字节，bytes在调用返回后即可复用
+ * - ini_parser_finish：输入结束，解析最后一个没有换行符的行
+ * 
+ * @return ini_parser_feed/ini_parser_finish返回目前为止的首条错误行号，0表示没有错误。
+ *         若启用INI_STOP_ON_FIRST_ERROR，出错后的喂入会被忽略
+ */
+INI_API void ini_parser_init(ini_parser* parser, ini_handler handler, void* user);
+INI_API void ini_parser_init_ex(ini_parser* parser, ini_handler_ex handler, void* user);
+INI_API int ini_parser_feed(ini_parser* parser, const char* bytes, size_t n);
+INI_API int ini_parser_finish(ini_parser* parser);
+
 #ifdef __cplusplus
 }
 #endif
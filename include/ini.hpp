@@ -0,0 +1,338 @@
+/**
+ * @file ini.hpp
+ * @brief inih解析器的header-only C++17模板版本
+ *
+ * @copyright Copyright (C) 2009-2025, Ben Hoyt
+ * @license SPDX-License-Identifier: BSD-3-Clause
+ *
+ * 与ini.h中的C接口相比：
+ *   - 语法方言（多行、注释前缀、行内注释等）是编译期的策略类型，而不是全局宏，
+ *     同一个程序可以同时使用多种方言，不需要任何运行时分派
+ *   - 回调是模板参数，可以被内联进扫描循环，死分支在编译期被消除
+ *   - 直接在调用者的缓冲区上解析（同ini_parse_string_length_ex），不拷贝、不写入
+ *
+ * 解析结果与使用同等配置宏编译的ini_parse_string_length_ex()逐字节一致。
+ *
+ * 使用示例：
+ * @code
+ * struct no_inline_comments : ini::default_dialect
+ * {
+ *     static constexpr bool allow_inline_comments = false;
+ * };
+ *
+ * int error = ini::parse<no_inline_comments>(text, [&](const ini::entry& e) {
+ *     values[std::string(e.section) + "." + std::string(e.name)] = e.value;
+ *     return true;
+ * });
+ * @endcode
+ *
+ * 项目主页：https://github.com/benhoyt/inih
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "ini.h"
+
+namespace ini
+{
+
+/**
+ * @struct default_dialect
+ * @brief 默认方言，取值与ini.h中对应配置宏的当前值相同
+ *
+ * 自定义方言时从它派生，只覆盖需要改变的成员即可。
+ */
+struct default_dialect
+{
+    static constexpr bool allow_multiline = INI_ALLOW_MULTILINE != 0;
+    static constexpr bool allow_bom = INI_ALLOW_BOM != 0;
+    static constexpr std::string_view start_comment_prefixes = INI_START_COMMENT_PREFIXES;
+    static constexpr bool allow_inline_comments = INI_ALLOW_INLINE_COMMENTS != 0;
+    static constexpr std::string_view inline_comment_prefixes = INI_INLINE_COMMENT_PREFIXES;
+    static constexpr bool allow_no_value = INI_ALLOW_NO_VALUE != 0;
+    static constexpr bool stop_on_first_error = INI_STOP_ON_FIRST_ERROR != 0;
+    static constexpr bool call_handler_on_new_section = INI_CALL_HANDLER_ON_NEW_SECTION != 0;
+    static constexpr std::size_t max_line = INI_MAX_LINE;
+    static constexpr std::size_t max_section = INI_MAX_SECTION;
+    static constexpr std::size_t max_name = INI_MAX_NAME;
+};
+
+/**
+ * @struct python_dialect
+ * @brief 匹配Python 3.2+ configparser：不允许行内注释
+ */
+struct python_dialect : default_dialect
+{
+    static constexpr bool allow_inline_comments = false;
+};
+
+/**
+ * @struct entry
+ * @brief 传给回调的条目，含义同ini_entry
+ *
+ * 新节回调（call_handler_on_new_section）中name.data()为nullptr；
+ * 无值键（allow_no_value）中value.data()为nullptr。
+ */
+struct entry
+{
+    std::string_view section;
+    std::string_view name;
+    std::string_view value;
+    int lineno;
+    std::size_t offset;
+};
+
+namespace detail
+{
+
+enum : unsigned char
+{
+    cls_space = 1,           // C locale下的空白字符
+    cls_start_comment = 2,   // 行首注释前缀
+    cls_inline_comment = 4,  // 行内注释前缀
+    cls_assign = 8,          // '='、':'
+    cls_close = 16,          // ']'
+};
+
+// 每种方言一张编译期生成的字符分类表，替代逐字节的strchr
+template <class Dialect>
+struct char_table
+{
+    static constexpr std::array<unsigned char, 256> make()
+    {
+        std::array<unsigned char, 256> t{};
+        for (unsigned char c : std::string_view(" \t\n\v\f\r"))
+            t[c] |= cls_space;
+        for (char c : Dialect::start_comment_prefixes)
+            t[static_cast<unsigned char>(c)] |= cls_start_comment;
+        for (char c : Dialect::inline_comment_prefixes)
+            t[static_cast<unsigned char>(c)] |= cls_inline_comment;
+        t[static_cast<unsigned char>('=')] |= cls_assign;
+        t[static_cast<unsigned char>(':')] |= cls_assign;
+        t[static_cast<unsigned char>(']')] |= cls_close;
+        // NUL不属于任何集合，只有行首的NUL同ini.c（strchr()能找到结尾的NUL）把整行当作注释
+        t[0] = cls_start_comment;
+        return t;
+    }
+
+    static constexpr std::array<unsigned char, 256> value = make();
+};
+
+template <class Dialect>
+constexpr bool is(char c, unsigned char cls)
+{
+    return (char_table<Dialect>::value[static_cast<unsigned char>(c)] & cls) != 0;
+}
+
+template <class Dialect>
+constexpr const char* lskip(const char* s, const char* end)
+{
+    while (s < end && is<Dialect>(*s, cls_space))
+        ++s;
+    return s;
+}
+
+template <class Dialect>
+constexpr const char* rstrip(const char* s, const char* end)
+{
+    while (end > s && is<Dialect>(end[-1], cls_space))
+        --end;
+    return end;
+}
+
+// 返回[s, end)中第一个属于chars类的字符或行内注释（前缀必须紧跟在空白之后）的位置
+template <class Dialect, unsigned char Chars>
+constexpr const char* find_chars_or_comment(const char* s, const char* end)
+{
+    bool was_space = false;
+    for (; s < end; ++s)
+    {
+        if constexpr (Chars != 0)
+        {
+            if (is<Dialect>(*s, Chars))
+                break;
+        }
+        if constexpr (Dialect::allow_inline_comments)
+        {
+            if (was_space && is<Dialect>(*s, cls_inline_comment))
+                break;
+            was_space = is<Dialect>(*s, cls_space);
+        }
+    }
+    return s;
+}
+
+template <class Dialect, class Callback>
+class parser
+{
+public:
+    explicit parser(Callback& callback) : _callback(callback) {}
+
+    int run(std::string_view buffer)
+    {
+        const char* p = buffer.data();
+        const char* end = p + buffer.size();
+
+        while (p < end)
+        {
+            const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+            std::size_t avail = nl ? static_cast<std::size_t>(nl - p) + 1 : static_cast<std::size_t>(end - p);
+            std::size_t len = nl ? static_cast<std::size_t>(nl - p) : avail;
+
+            ++_lineno;
+            _offset = static_cast<std::size_t>(p - buffer.data());
+            // 超过max_line的行被截断，并记为错误行
+            if (avail > Dialect::max_line - 1)
+            {
+                len = Dialect::max_line - 1;
+                fail();
+            }
+            line(p, p + len);
+            if constexpr (Dialect::stop_on_first_error)
+            {
+                if (_error)
+                    break;
+            }
+            p += avail;
+        }
+        return _error;
+    }
+
+private:
+    void fail()
+    {
+        if (!_error)
+            _error = _lineno;
+    }
+
+    void emit(std::string_view name, std::string_view value)
+    {
+        entry e{_section, name, value, _lineno, _offset};
+        if constexpr (std::is_void_v<std::invoke_result_t<Callback&, const entry&>>)
+        {
+            _callback(e);
+        }
+        else
+        {
+            if (!_callback(e))
+                fail();
+        }
+    }
+
+    void line(const char* line, const char* line_end)
+    {
+        const char* start = line;
+
+        if constexpr (Dialect::allow_bom)
+        {
+            if (_lineno == 1 && line_end - start >= 3 &&
+                static_cast<unsigned char>(start[0]) == 0xEF &&
+                static_cast<unsigned char>(start[1]) == 0xBB &&
+                static_cast<unsigned char>(start[2]) == 0xBF)
+            {
+                start += 3;
+            }
+        }
+        start = lskip<Dialect>(start, line_end);
+        line_end = rstrip<Dialect>(start, line_end);
+
+        if (start == line_end || is<Dialect>(*start, cls_start_comment))
+            return;  // 空行或行首注释
+
+        if constexpr (Dialect::allow_multiline)
+        {
+            if (!_prev_name.empty() && start > line)
+            {
+                // 带有前导空格的非空行，视为上一个键的续行
+                if constexpr (Dialect::allow_inline_comments)
+                    line_end = rstrip<Dialect>(start, find_chars_or_comment<Dialect, 0>(start, line_end));
+                emit(_prev_name, view(start, line_end));
+                return;
+            }
+        }
+
+        if (*start == '[')
+        {
+            const char* end = find_chars_or_comment<Dialect, cls_close>(start + 1, line_end);
+            if (end < line_end && *end == ']')
+            {
+                _section = truncate(view(start + 1, end), Dialect::max_section);
+                _prev_name = std::string_view();
+                if constexpr (Dialect::call_handler_on_new_section)
+                    emit(std::string_view(), std::string_view());
+            }
+            else
+            {
+                fail();  // 节没有以]结尾
+            }
+            return;
+        }
+
+        // 不是注释的话，必须是name=value或者name:value
+        const char* end = find_chars_or_comment<Dialect, cls_assign>(start, line_end);
+        if (end < line_end && is<Dialect>(*end, cls_assign))
+        {
+            std::string_view name = view(start, rstrip<Dialect>(start, end));
+            const char* value = end + 1;
+            const char* value_end = line_end;
+            if constexpr (Dialect::allow_inline_comments)
+                value_end = find_chars_or_comment<Dialect, 0>(value, line_end);
+            value = lskip<Dialect>(value, value_end);
+            value_end = rstrip<Dialect>(value, value_end);
+
+            if constexpr (Dialect::allow_multiline)
+                _prev_name = truncate(name, Dialect::max_name);
+            emit(name, view(value, value_end));
+        }
+        else if constexpr (Dialect::allow_no_value)
+        {
+            emit(view(start, rstrip<Dialect>(start, end)), std::string_view());
+        }
+        else
+        {
+            fail();  // 没有找到=或者:
+        }
+    }
+
+    static std::string_view view(const char* begin, const char* end)
+    {
+        return std::string_view(begin, static_cast<std::size_t>(end - begin));
+    }
+
+    // 与C版本一样，节名和续行使用的键名最多保留size - 1字节
+    static std::string_view truncate(std::string_view s, std::size_t size)
+    {
+        return s.size() > size - 1 ? s.substr(0, size - 1) : s;
+    }
+
+    Callback& _callback;
+    std::string_view _section{"", 0};
+    std::string_view _prev_name;
+    int _lineno = 0;
+    std::size_t _offset = 0;
+    int _error = 0;
+};
+
+}  // namespace detail
+
+/**
+ * @brief 按Dialect方言解析buffer，每个条目调用一次callback
+ *
+ * @param buffer INI数据，解析期间必须保持有效，不会被修改
+ * @param callback 可调用对象，签名为bool(const ini::entry&)（返回false表示该行出错）
+ *                 或void(const ini::entry&)
+ * @return 0表示成功，>0为首条错误所在行号
+ */
+template <class Dialect = default_dialect, class Callback>
+int parse(std::string_view buffer, Callback&& callback)
+{
+    return detail::parser<Dialect, std::remove_reference_t<Callback>>(callback).run(buffer);
+}
+
+}  // namespace ini
@@ -0,0 +1,550 @@
+/**
+ * @file ini_bind.hpp
+ * @brief 把INI数据直接解析进C++结构体的编译期绑定层
+ *
+ * @copyright Copyright (C) 2009-2025, Ben Hoyt
+ * @license SPDX-License-Identifier: BSD-3-Clause
+ *
+ * 只读取固定字段的程序不需要先建一个INIReader再逐个Get()拷出来：用constexpr字段表
+ * 描述{节名, 键名, &结构体::成员}，ini::bind()在ini::parse()的单次扫描中，
+ * 对每个条目用编译期生成的完美哈希找到字段，再经编译期生成的函数表把值直接解析进成员。
+ * 不建中间表、不拷贝键名，未知键在同一次扫描中交给回调。
+ *
+ *   - 节名和键名不区分大小写（同INIReader，只折叠ASCII）
+ *   - 值必须整体有效：整数接受可选符号、十进制、"0x"十六进制和"0"开头的八进制，
+ *     且不能超出成员类型的范围；浮点数为十进制；布尔值为true/yes/on/1或false/no/off/0；
+ *     无效的值记为该行出错，成员保持原值
+ *   - 同一个键出现多次（包括多行值的续行）时与INIReader一致：std::string成员以"\n"
+ *     连接各次的值（同INIReader::Get()），std::vector<T>成员逐次追加；其他成员
+ *     （包括std::string_view）无法表示多个值，之后的每次出现都记为该行出错，成员保留第一次的值
+ *   - std::string_view成员直接指向输入缓冲区，缓冲区必须比结构体活得久
+ *   - 其他类型可特化ini::value_parser<T>
+ *
+ * 使用示例：
+ * @code
+ * struct server_config
+ * {
+ *     std::string host = "localhost";
+ *     int port = 80;
+ *     double timeout = 1.5;
+ *     std::vector<std::string> aliases;
+ * };
+ *
+ * constexpr auto server_schema = ini::fields(
+ *     ini::field("server", "host", &server_config::host),
+ *     ini::field("server", "port", &server_config::port),
+ *     ini::field("server", "timeout", &server_config::timeout),
+ *     ini::field("server", "alias", &server_config::aliases));
+ *
+ * server_config config;
+ * int error = ini::bind(text, config, server_schema, [](const ini::entry& e) {
+ *     std::cerr << "unknown key " << e.section << "." << e.name << "\n";
+ * });
+ * @endcode
+ *
+ * 项目主页：https://github.com/benhoyt/inih
+ */
+
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ini.hpp"
+
+namespace ini
+{
+
+/**
+ * @struct value_parser
+ * @brief 把一个值解析进类型T的成员；parse()返回false表示值无效
+ *
+ * 为自定义类型提供特化：
+ * @code
+ * template <> struct ini::value_parser<color>
+ * {
+ *     static bool parse(std::string_view value, color& out);
+ * };
+ * @endcode
+ */
+template <class T, class Enable = void>
+struct value_parser;
+
+namespace detail
+{
+
+constexpr char lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+}
+
+constexpr bool is_space(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+constexpr bool equal_lower(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); i++)
+    {
+        if (lower(a[i]) != lower(b[i]))
+            return false;
+    }
+    return true;
+}
+
+// 不区分大小写的(节名, 键名)哈希
+constexpr std::uint32_t key_hash(std::string_view section, std::string_view name)
+{
+    std::uint32_t h = 2166136261u;
+    for (char c : section)
+        h = (h ^ static_cast<unsigned char>(lower(c))) * 16777619u;
+    h = (h ^ 0x100u) * 16777619u;  // 分隔节名和键名，使("ab","c")与("a","bc")不同
+    for (char c : name)
+        h = (h ^ static_cast<unsigned char>(lower(c))) * 16777619u;
+    return h;
+}
+
+// 键哈希经所在组的位移d打散后的槽位
+constexpr std::uint32_t displace(std::uint32_t h, std::uint32_t d)
+{
+    h += d * 0x9e3779b9u;
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
+template <class T>
+struct is_vector : std::false_type
+{
+};
+
+template <class T, class Allocator>
+struct is_vector<std::vector<T, Allocator>> : std::true_type
+{
+};
+
+// 不小于n的最小2的幂
+constexpr std::size_t pow2_at_least(std::size_t n)
+{
+    std::size_t size = 1;
+    while (size < n)
+        size *= 2;
+    return size;
+}
+
+}  // namespace detail
+
+/**
+ * @struct field_def
+ * @brief 字段表中的一项：节名、键名和成员指针，由ini::field()生成
+ */
+template <class Struct, class T>
+struct field_def
+{
+    std::string_view section;
+    std::string_view name;
+    T Struct::*member;
+};
+
+/**
+ * @brief 生成一项字段定义
+ */
+template <class Struct, class T>
+constexpr field_def<Struct, T> field(std::string_view section, std::string_view name, T Struct::*member)
+{
+    return field_def<Struct, T>{section, name, member};
+}
+
+namespace detail
+{
+
+// 第I个字段的成员指针。schema把所有字段作为平铺的基类保存，按下标取成员只是一次
+// static_cast，避免std::tuple递归实例化在字段多时带来的编译开销
+template <std::size_t I, class Struct, class T>
+struct field_member
+{
+    T Struct::*member;
+};
+
+template <class Struct, class Indices, class... T>
+struct field_members;
+
+template <class Struct, std::size_t... I, class... T>
+struct field_members<Struct, std::index_sequence<I...>, T...> : field_member<I, Struct, T>...
+{
+    constexpr explicit field_members(field_def<Struct, T>... defs)
+        : field_member<I, Struct, T>{defs.member}...
+    {
+    }
+};
+
+}  // namespace detail
+
+/**
+ * @class schema
+ * @brief 结构体Struct的字段表及其完美哈希，由ini::fields()在编译期构建
+ *
+ * 完美哈希采用hash-and-displace（同INICache）：键哈希的低位选组，平均每组约两个键，
+ * 组内所有键共用一个位移d，构建时按组从大到小为每组找到使其键全部落入空槽的d；
+ * 槽位数为不小于2N的2的幂，每个槽位存字段下标+1（0为空）。查找只需一次哈希、
+ * 两次数组访问和一次比较，再经编译期生成的函数表调用该成员类型的解析器。
+ * 两个键（不区分大小写）相同时无法构建，在常量求值中表现为编译错误。
+ */
+template <class Struct, class... T>
+class schema
+{
+public:
+    static constexpr std::size_t size = sizeof...(T);
+    static_assert(size > 0, "a schema needs at least one field");
+    static_assert(size < 65535, "too many fields");
+
+    constexpr explicit schema(field_def<Struct, T>... defs)
+        : _members(defs...), _keys{{std::make_pair(defs.section, defs.name)...}}, _hashes{}, _disp{}, _slots{}
+    {
+        for (std::size_t i = 0; i < size; i++)
+            _hashes[i] = detail::key_hash(_keys[i].first, _keys[i].second);
+        build();
+    }
+
+    /**
+     * @brief 查找(节名, 键名)对应的字段下标，不存在时返回size
+     */
+    constexpr std::size_t find(std::string_view section, std::string_view name) const
+    {
+        std::uint32_t h = detail::key_hash(section, name);
+        std::size_t index = _slots[detail::displace(h, _disp[h & (group_count - 1)]) & (slot_count - 1)];
+        if (index == 0)
+            return size;
+        const std::pair<std::string_view, std::string_view>& key = _keys[index - 1];
+        return detail::equal_lower(key.second, name) && detail::equal_lower(key.first, section) ? index - 1 : size;
+    }
+
+    /**
+     * @brief 把value解析进第index个字段对应的成员，值无效时返回false
+     *
+     * repeat表示该键在本次解析中已经出现过（续行或重复的键）：std::string成员以"\n"
+     * 追加，std::vector<T>成员追加一个元素，其他成员返回false
+     */
+    bool assign(std::size_t index, Struct& out, std::string_view value, bool repeat = false) const
+    {
+        return assigners[index](*this, out, value, repeat);
+    }
+
+private:
+    typedef detail::field_members<Struct, std::index_sequence_for<T...>, T...> members;
+    typedef bool (*assigner)(const schema&, Struct&, std::string_view, bool);
+
+    static constexpr std::size_t group_count = detail::pow2_at_least((size + 1) / 2);
+    static constexpr std::size_t slot_count = detail::pow2_at_least(2 * size);
+
+    template <std::size_t I, class U>
+    static bool assign_member(const schema& s, Struct& out, std::string_view value, bool repeat)
+    {
+        const detail::field_member<I, Struct, U>& def = s._members;
+        if (repeat)
+        {
+            if constexpr (std::is_same_v<std::remove_cv_t<U>, std::string>)
+            {
+                (out.*(def.member) += '\n').append(value.data(), value.size());
+                return true;
+            }
+            else if constexpr (!detail::is_vector<std::remove_cv_t<U>>::value)
+            {
+                return false;
+            }
+        }
+        return value_parser<std::remove_cv_t<U>>::parse(value, out.*(def.member));
+    }
+
+    template <std::size_t... I>
+    static constexpr std::array<assigner, size> make_assigners(std::index_sequence<I...>)
+    {
+        return {{&assign_member<I, T>...}};
+    }
+
+    // 第i项解析第i个字段，编译期生成
+    static constexpr std::array<assigner, size> assigners = make_assigners(std::index_sequence_for<T...>());
+
+    constexpr void build()
+    {
+        // 按组对键做计数排序，之后每组的键在order中连续
+        std::array<std::size_t, group_count + 1> start{};
+        for (std::size_t i = 0; i < size; i++)
+            start[(_hashes[i] & (group_count - 1)) + 1]++;
+        std::size_t largest = 0;
+        for (std::size_t g = 0; g < group_count; g++)
+        {
+            largest = start[g + 1] > largest ? start[g + 1] : largest;
+            start[g + 1] += start[g];
+        }
+        std::array<std::uint16_t, size> order{};
+        std::array<std::size_t, group_count> fill{};
+        for (std::size_t i = 0; i < size; i++)
+        {
+            std::size_t g = _hashes[i] & (group_count - 1);
+            order[start[g] + fill[g]++] = static_cast<std::uint16_t>(i);
+        }
+
+        // 大的组先放，空槽多时更容易找到位移
+        for (std::size_t n = largest; n > 0; n--)
+        {
+            for (std::size_t g = 0; g < group_count; g++)
+            {
+                if (start[g + 1] - start[g] == n)
+                    place(g, order.data() + start[g], n);
+            }
+        }
+    }
+
+    constexpr void place(std::size_t group, const std::uint16_t* keys, std::size_t n)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            for (std::size_t j = 0; j < i; j++)
+            {
+                if (_hashes[keys[i]] == _hashes[keys[j]] &&
+                    detail::equal_lower(_keys[keys[i]].first, _keys[keys[j]].first) &&
+                    detail::equal_lower(_keys[keys[i]].second, _keys[keys[j]].second))
+                    throw "ini::fields: duplicate section/name";
+            }
+        }
+
+        for (std::uint32_t d = 0; ; d++)
+        {
+            std::size_t taken[8] = {};  // 组内前8个键的槽位；更大的组逐个比较
+            bool fits = true;
+            for (std::size_t i = 0; i < n && fits; i++)
+            {
+                std::size_t slot = detail::displace(_hashes[keys[i]], d) & (slot_count - 1);
+                fits = _slots[slot] == 0;
+                for (std::size_t j = 0; j < i && fits; j++)
+                {
+                    std::size_t other = j < 8 ? taken[j]
+                                              : detail::displace(_hashes[keys[j]], d) & (slot_count - 1);
+                    fits = other != slot;
+                }
+                if (i < 8)
+                    taken[i] = slot;
+            }
+            if (!fits)
+                continue;
+            _disp[group] = d;
+            for (std::size_t i = 0; i < n; i++)
+                _slots[detail::displace(_hashes[keys[i]], d) & (slot_count - 1)] = static_cast<std::uint16_t>(keys[i] + 1);
+            return;
+        }
+    }
+
+    members _members;
+    std::array<std::pair<std::string_view, std::string_view>, size> _keys;
+    std::array<std::uint32_t, size> _hashes;
+    std::array<std::uint32_t, group_count> _disp;
+    std::array<std::uint16_t, slot_count> _slots;
+};
+
+/**
+ * @brief 由字段定义构建schema，通常用于constexpr变量
+ */
+template <class Struct, class... T>
+constexpr schema<Struct, T...> fields(field_def<Struct, T>... defs)
+{
+    return schema<Struct, T...>(defs...);
+}
+
+/**
+ * @brief 按Dialect方言解析buffer，把schema中的键直接解析进out的成员
+ *
+ * @param buffer INI数据，解析期间必须保持有效，不会被修改
+ * @param out 目标结构体，没有出现的字段保持原值
+ * @param fields ini::fields()构建的字段表
+ * @param on_unknown 可调用对象，签名为void(const ini::entry&)，每个不在字段表中的键调用一次
+ * @return 0表示成功，>0为首条错误所在行号（语法错误或无效的值）
+ */
+template <class Dialect = default_dialect, class Struct, class... T, class Unknown>
+int bind(std::string_view buffer, Struct& out, const schema<Struct, T...>& fields, Unknown&& on_unknown)
+{
+    std::array<bool, sizeof...(T)> seen{};  // 本次解析中已经赋过值的字段
+    return parse<Dialect>(buffer, [&](const entry& e) {
+        if (!e.name.data())  // call_handler_on_new_section的新节回调
+            return true;
+        std::size_t index = fields.find(e.section, e.name);
+        if (index == fields.size)
+        {
+            on_unknown(e);
+            return true;
+        }
+        if (e.value.data() == nullptr || !fields.assign(index, out, e.value, seen[index]))
+            return false;
+        seen[index] = true;
+        return true;
+    });
+}
+
+/**
+ * @brief 同上，忽略未知键
+ */
+template <class Dialect = default_dialect, class Struct, class... T>
+int bind(std::string_view buffer, Struct& out, const schema<Struct, T...>& fields)
+{
+    return bind<Dialect>(buffer, out, fields, [](const entry&) {});
+}
+
+// 整数：可选符号，"0x"十六进制、"0"开头八进制或十进制，必须整体有效且在T的范围内
+template <class T>
+struct value_parser<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+{
+    static bool parse(std::string_view value, T& out)
+    {
+        using U = std::make_unsigned_t<T>;
+        const char* p = value.data();
+        const char* end = p + value.size();
+        bool negative = false;
+        if (p < end && (*p == '+' || *p == '-'))
+            negative = *p++ == '-';
+        int base = 10;
+        if (end - p > 1 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
+        {
+            base = 16;
+            p += 2;
+        }
+        else if (end - p > 1 && p[0] == '0')
+        {
+            base = 8;
+        }
+
+        U magnitude = 0;
+        std::from_chars_result result = std::from_chars(p, end, magnitude, base);
+        if (result.ec != std::errc() || result.ptr != end)
+            return false;
+        if constexpr (std::is_signed_v<T>)
+        {
+            U limit = static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+            if (magnitude > limit)
+                return false;
+            out = static_cast<T>(negative ? U(0) - magnitude : magnitude);
+        }
+        else
+        {
+            if (negative && magnitude != 0)
+                return false;
+            out = static_cast<T>(magnitude);
+        }
+        return true;
+    }
+};
+
+// 浮点数：十进制或科学计数法，可带符号，必须整体有效且不溢出。标准库没有浮点
+// from_chars时（同INIText.h的ParseReal()）退回到对以NUL结尾的副本调用strtod
+template <class T>
+struct value_parser<T, std::enable_if_t<std::is_floating_point_v<T>>>
+{
+    static bool parse(std::string_view value, T& out)
+    {
+        const char* p = value.data();
+        const char* end = p + value.size();
+        if (p < end && *p == '+')
+        {
+            p++;
+            if (p < end && *p == '-')
+                return false;
+        }
+        T parsed;
+#if defined(__cpp_lib_to_chars)
+        std::from_chars_result result = std::from_chars(p, end, parsed);
+        if (result.ec != std::errc() || result.ptr != end)
+            return false;
+#else
+        // strtod还接受前导空白、"+"和十六进制浮点数，from_chars都不接受
+        const char* digits = p < end && *p == '-' ? p + 1 : p;
+        if (digits == end || *digits == '+' || detail::is_space(*digits) ||
+            (end - digits > 1 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')))
+            return false;
+        std::string copy(p, end);
+        char* copy_end;
+        errno = 0;
+        long double converted = std::strtold(copy.c_str(), &copy_end);
+        long double magnitude = converted < 0 ? -converted : converted;
+        bool finite = magnitude <= std::numeric_limits<long double>::max();  // NaN也不满足
+        if (copy_end != copy.c_str() + copy.size() || errno == ERANGE ||
+            (finite && magnitude > std::numeric_limits<T>::max()))
+            return false;
+        parsed = static_cast<T>(converted);
+#endif
+        out = parsed;
+        return true;
+    }
+};
+
+template <>
+struct value_parser<bool>
+{
+    static bool parse(std::string_view value, bool& out)
+    {
+        if (detail::equal_lower(value, "true") || detail::equal_lower(value, "yes") ||
+            detail::equal_lower(value, "on") || value == "1")
+        {
+            out = true;
+            return true;
+        }
+        if (detail::equal_lower(value, "false") || detail::equal_lower(value, "no") ||
+            detail::equal_lower(value, "off") || value == "0")
+        {
+            out = false;
+            return true;
+        }
+        return false;
+    }
+};
+
+template <>
+struct value_parser<std::string>
+{
+    static bool parse(std::string_view value, std::string& out)
+    {
+        out.assign(value.data(), value.size());
+        return true;
+    }
+};
+
+// 直接指向输入缓冲区，不拷贝
+template <>
+struct value_parser<std::string_view>
+{
+    static bool parse(std::string_view value, std::string_view& out)
+    {
+        out = value;
+        return true;
+    }
+};
+
+// 键每出现一次追加一个元素
+template <class T, class Allocator>
+struct value_parser<std::vector<T, Allocator>>
+{
+    static bool parse(std::string_view value, std::vector<T, Allocator>& out)
+    {
+        T parsed{};
+        if (!value_parser<T>::parse(value, parsed))
+            return false;
+        out.push_back(std::move(parsed));
+        return true;
+    }
+};
+
+}  // namespace ini
@@ -0,0 +1,194 @@
+/**
+ * @file ConfigSnapshot.cpp
+ * @brief 不可变配置快照及其无锁发布器
+ *
+ * @copyright Copyright (C) 2009-2025, Ben Hoyt
+ * @license SPDX-License-Identifier: BSD-3-Clause
+ *
+ * ConfigPublisher用一个原子指针保存当前快照，读者不加锁、也不对共享内存做读-改-写，
+ * 被替换的快照采用基于纪元(epoch)的回收：
+ *
+ *   - 全局纪元计数器g_epoch，每次Publish()加一；
+ *   - 每个读线程独占一个按缓存行对齐的槽位，读开始时把当时的纪元写入槽位，读结束时清零；
+ *   - 快照被替换时记下替换后的纪元R，只有当所有槽位都为0或不小于R时才删除它。
+ *
+ * 读者依次执行：acquire读纪元、seq_cst写槽位、seq_cst读当前指针；写者依次执行：
+ * seq_cst交换当前指针、纪元加一、seq_cst扫描槽位。若写者扫描时没有看到某读者的槽位，
+ * 该读者随后读到的必然是新指针；若看到的纪元不小于R，该读者读纪元时已与加一同步，
+ * 同样只会读到新指针。因此被删除的快照不可能再被任何读者看到。
+ *
+ * 槽位组成一个只增不减的全局链表，线程退出时归还槽位供新线程复用，槽位本身从不释放。
+ *
+ * 项目主页：https://github.com/benhoyt/inih
+ */
+
+#include <algorithm>
+#include "ConfigSnapshot.h"
+
+struct ConfigPublisher::ReaderSlot
+{
+    alignas(64) std::atomic<uint64_t> epoch;    // 0 when the thread isn't reading
+    std::atomic<bool> in_use;
+    unsigned depth;                             // Nested guards; owner thread only
+    ReaderSlot* next;
+};
+
+namespace
+{
+
+typedef ConfigPublisher::ReaderSlot ReaderSlot;
+
+std::atomic<ReaderSlot*> g_slots(nullptr);
+std::atomic<uint64_t> g_epoch(1);
+
+// The calling thread's slot. Kept in a trivially-constructed thread_local
+// so that the read path doesn't go through a TLS init wrapper
+thread_local ReaderSlot* t_slot = nullptr;
+
+// Returns the slot to the free list when its thread exits
+struct SlotRelease
+{
+    ~SlotRelease()
+    {
+        if (t_slot)
+        {
+            t_slot->in_use.store(false, std::memory_order_release);
+            t_slot = nullptr;
+        }
+    }
+};
+
+thread_local SlotRelease t_release;
+
+ReaderSlot* RegisterSlot()
+{
+    ReaderSlot* slot = nullptr;
+    for (ReaderSlot* s = g_slots.load(std::memory_order_acquire); s; s = s->next)
+    {
+        bool used = false;
+        if (!s->in_use.load(std::memory_order_relaxed) &&
+            s->in_use.compare_exchange_strong(used, true, std::memory_order_acquire))
+        {
+            slot = s;
+            break;
+        }
+    }
+    if (!slot)
+    {
+        slot = new ReaderSlot;
+        slot->epoch.store(0, std::memory_order_relaxed);
+        slot->in_use.store(true, std::memory_order_relaxed);
+        slot->depth = 0;
+        slot->next = g_slots.load(std::memory_order_relaxed);
+        while (!g_slots.compare_exchange_weak(slot->next, slot, std::memory_order_release,
+                                              std::memory_order_relaxed))
+        {
+        }
+    }
+    (void)&t_release;  // Make sure the slot is given back at thread exit
+    t_slot = slot;
+    return slot;
+}
+
+// Oldest epoch any thread is reading under, or UINT64_MAX if none is reading
+uint64_t OldestReader()
+{
+    uint64_t oldest = UINT64_MAX;
+    for (ReaderSlot* s = g_slots.load(std::memory_order_acquire); s; s = s->next)
+    {
+        uint64_t epoch = s->epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch < oldest)
+            oldest = epoch;
+    }
+    return oldest;
+}
+
+}  // namespace
+
+ConfigSnapshot::ConfigSnapshot(const std::string& filename)
+    : INIReader(filename), _version(0)
+{
+}
+
+ConfigSnapshot::ConfigSnapshot(const char* buffer, size_t buffer_size)
+    : INIReader(buffer, buffer_size), _version(0)
+{
+}
+
+ConfigPublisher::ConfigPublisher(std::unique_ptr<ConfigSnapshot> initial)
+    : _current(nullptr), _version(0)
+{
+    if (initial)
+        Publish(std::move(initial));
+}
+
+ConfigPublisher::~ConfigPublisher()
+{
+    delete _current.load(std::memory_order_relaxed);
+    for (const auto& retired : _retired)
+        delete retired.first;
+}
+
+ConfigPublisher::ReadGuard ConfigPublisher::Read() const
+{
+    ReaderSlot* slot = t_slot;
+    if (!slot)
+        slot = RegisterSlot();
+    // Nested guards are covered by the outermost one's epoch
+    if (slot->depth++ == 0)
+        slot->epoch.store(g_epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+    return ReadGuard(slot, _current.load(std::memory_order_seq_cst));
+}
+
+void ConfigPublisher::Leave(ReaderSlot* slot)
+{
+    if (--slot->depth == 0)
+        slot->epoch.store(0, std::memory_order_release);
+}
+
+void ConfigPublisher::Publish(std::unique_ptr<ConfigSnapshot> next)
+{
+    if (!next)
+        return;
+    std::lock_guard<std::mutex> lock(_write_mutex);
+    next->_version = ++_version;
+    const ConfigSnapshot* old = _current.exchange(next.release(), std::memory_order_seq_cst);
+    uint64_t epoch = g_epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+    if (old)
+        _retired.push_back(std::make_pair(old, epoch));
+    FreeRetired();
+}
+
+int ConfigPublisher::Reload(const std::string& filename)
+{
+    std::unique_ptr<ConfigSnapshot> next(new ConfigSnapshot(filename));
+    int error = next->ParseError();
+    if (error == 0)
+        Publish(std::move(next));
+    return error;
+}
+
+size_t ConfigPublisher::Reclaim()
+{
+    std::lock_guard<std::mutex> lock(_write_mutex);
+    return FreeRetired();
+}
+
+uint64_t ConfigPublisher::Version() const
+{
+    ReadGuard current = Read();
+    return current ? current->Version() : 0;
+}
+
+// Delete the retired snapshots replaced at or before the oldest epoch still
+// being read under; _write_mutex must be held
+size_t ConfigPublisher::FreeRetired()
+{
+    uint64_t oldest = OldestReader();
+    auto freed = std::partition(_retired.begin(), _retired.end(),
+        [oldest](const std::pair<const ConfigSnapshot*, uint64_t>& retired) { return retired.second > oldest; });
+    for (auto it = freed; it != _retired.end(); ++it)
+        delete it->first;
+    _retired.erase(freed, _retired.end());
+    return _retired.size();
+}
@@ -0,0 +1,820 @@
+/**
+ * @file INICache.cpp
+ * @brief INI文件的二进制编译缓存
+ *
+ * @copyright Copyright (C) 2009-2025, Ben Hoyt
+ * @license SPDX-License-Identifier: BSD-3-Clause
+ *
+ * 首次加载时解析源文件，把所有键值对编译成一个与位置无关的二进制映像并写到源文件旁边；
+ * 之后的进程只要源文件的大小、mtime和内容哈希都没有变化，就直接mmap该映像，
+ * 不解析、不建表，映射完成即可查找。映像布局（所有偏移都相对于映像起始处）：
+ *
+ *   Header
+ *   Entry   entries[entry_count]     按(节名, 键名)排序，同一节的条目连续
+ *   Section sections[section_count]  按节名排序
+ *   uint32  disp[group_count]        完美哈希的每组位移
+ *   uint32  slots[slot_count]        槽位 -> 条目下标，空槽为kEmpty
+ *   char    pool[pool_size]          节名、键名（均已转小写）和值，各自以NUL结尾，值紧跟在键名之后
+ *
+ * 完美哈希采用hash-and-displace：键的64位哈希先落到一个组，组内所有键共用一个位移d，
+ * 构建时为每组找到使其键全部落入空槽的d。查找时只需一次哈希、两次数组访问和一次比较。
+ *
+ * 项目主页：https://github.com/benhoyt/inih
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <sys/stat.h>
+#include "ini.h"
+#include "INICache.h"
+#include "INIText.h"
+
+#if INI_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using std::string;
+using std::string_view;
+using namespace ini_text;
+
+namespace
+{
+
+const char kMagic[8] = {'I', 'N', 'I', 'C', 'A', 'C', 'H', 'E'};
+const uint32_t kVersion = 2;
+const uint32_t kEndian = 0x01020304;
+const uint32_t kEmpty = 0xffffffffu;
+const int kMaxSeeds = 16;
+const uint32_t kMaxDisplacement = 1u << 20;
+
+// Map a 32-bit hash onto [0, n) without a division
+inline uint32_t Reduce(uint32_t x, uint32_t n)
+{
+    return static_cast<uint32_t>((static_cast<uint64_t>(x) * n) >> 32);
+}
+
+inline uint32_t Slot(uint64_t h, uint32_t d, uint32_t slot_count)
+{
+    return Reduce(static_cast<uint32_t>(Mix(h + d * 0x9e3779b97f4a7c15ULL)), slot_count);
+}
+
+// Hash of the source contents, 8 bytes at a time
+uint64_t ContentHash(const char* data, size_t size)
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t w;
+        memcpy(&w, data + i, 8);
+        h = (h ^ Mix(w)) * 0x9fb21c651e98df25ULL;
+        h ^= h >> 29;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, data + i, size - i);
+    return Mix(h ^ Mix(tail ^ 0x5555555555555555ULL));
+}
+
+// Parser options that change what a source file compiles to
+uint64_t OptionsHash()
+{
+    static const uint64_t options[] = {
+        INI_ALLOW_MULTILINE, INI_ALLOW_BOM, INI_ALLOW_INLINE_COMMENTS,
+        INI_ALLOW_NO_VALUE, INI_STOP_ON_FIRST_ERROR, INI_ALLOW_REALLOC,
+        INI_MAX_LINE, INI_MAX_SECTION, INI_MAX_NAME,
+    };
+    static const char prefixes[] = INI_START_COMMENT_PREFIXES "\n" INI_INLINE_COMMENT_PREFIXES;
+    return ContentHash(reinterpret_cast<const char*>(options), sizeof(options)) ^
+           Mix(ContentHash(prefixes, sizeof(prefixes)));
+}
+
+// Compare a query string case-insensitively against a lower-cased stored one
+int CompareLower(string_view query, const char* stored, size_t stored_len)
+{
+    size_t n = std::min(query.size(), stored_len);
+    for (size_t i = 0; i < n; i++)
+    {
+        unsigned char a = static_cast<unsigned char>(LowerChar(query[i]));
+        unsigned char b = static_cast<unsigned char>(stored[i]);
+        if (a != b)
+            return a < b ? -1 : 1;
+    }
+    return query.size() < stored_len ? -1 : query.size() > stored_len ? 1 : 0;
+}
+
+// Source file contents plus the size and mtime used to validate the cache
+class SourceFile
+{
+public:
+    SourceFile() : data(nullptr), size(0), mtime(0), _map(nullptr) {}
+
+    ~SourceFile()
+    {
+#if INI_USE_MMAP
+        if (_map)
+            munmap(_map, size);
+#endif
+    }
+
+    // The mtime and the size always come from an fstat() of the descriptor
+    // the bytes are read through, so that all three describe the same file
+    bool Open(const string& filename)
+    {
+        struct stat sb;
+#if INI_USE_MMAP
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        if (fstat(fd, &sb) != 0)
+        {
+            close(fd);
+            return false;
+        }
+        mtime = MtimeOf(sb);
+        size = static_cast<size_t>(sb.st_size);
+        if (size > 0)
+        {
+            void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED)
+            {
+                madvise(map, size, MADV_SEQUENTIAL);
+                _map = map;
+                data = static_cast<const char*>(map);
+            }
+        }
+        close(fd);
+        if (_map || size == 0)
+        {
+            if (!_map)
+                data = "";
+            return true;
+        }
+#endif
+        FILE* file = fopen(filename.c_str(), "rb");
+        if (!file)
+            return false;
+        if (fstat(fileno(file), &sb) != 0)
+        {
+            fclose(file);
+            return false;
+        }
+        mtime = MtimeOf(sb);
+        char block[65536];
+        size_t n;
+        _buffer.clear();
+        while ((n = fread(block, 1, sizeof(block), file)) > 0)
+            _buffer.append(block, n);
+        fclose(file);
+        data = _buffer.data();
+        size = _buffer.size();
+        return true;
+    }
+
+    const char* data;
+    size_t size;
+    int64_t mtime;
+
+private:
+    static int64_t MtimeOf(const struct stat& sb)
+    {
+#if defined(__APPLE__)
+        return static_cast<int64_t>(sb.st_mtimespec.tv_sec) * 1000000000 + sb.st_mtimespec.tv_nsec;
+#elif defined(__unix__)
+        return static_cast<int64_t>(sb.st_mtim.tv_sec) * 1000000000 + sb.st_mtim.tv_nsec;
+#else
+        return static_cast<int64_t>(sb.st_mtime) * 1000000000;
+#endif
+    }
+
+    void* _map;
+    string _buffer;
+};
+
+struct BuildEntry
+{
+    string name;
+    string value;
+};
+
+struct BuildSection
+{
+    string name;
+    std::vector<uint32_t> entries;
+};
+
+struct Builder
+{
+    Builder() : current(kEmpty) {}
+
+    std::vector<BuildEntry> entries;
+    std::vector<BuildSection> sections;
+    std::unordered_map<string, uint32_t> index;          // "section=name" -> entry
+    std::unordered_map<string, uint32_t> section_index;  // section -> sections[]
+    uint32_t current;                                    // Section of the previous entry
+};
+
+// Same joining rules as INIReader::Joined(): a "\n" goes only after text
+int BuildHandler(void* user, const ini_entry* entry)
+{
+    if (!entry->name)  // Happens when INI_CALL_HANDLER_ON_NEW_SECTION enabled
+        return 1;
+
+    Builder* builder = static_cast<Builder*>(user);
+    string key;
+    key.reserve(entry->section_len + 1 + entry->name_len);
+    for (size_t i = 0; i < entry->section_len; i++)
+        key += LowerChar(entry->section[i]);
+    key += '=';
+    for (size_t i = 0; i < entry->name_len; i++)
+        key += LowerChar(entry->name[i]);
+
+    std::pair<std::unordered_map<string, uint32_t>::iterator, bool> ins =
+        builder->index.emplace(key, static_cast<uint32_t>(builder->entries.size()));
+    if (ins.second)
+    {
+        // Entries usually arrive a whole section at a time, so only look the
+        // section up when it differs from the previous entry's
+        string_view section(key.data(), entry->section_len);
+        if (builder->current == kEmpty || builder->sections[builder->current].name != section)
+        {
+            std::pair<std::unordered_map<string, uint32_t>::iterator, bool> sec =
+                builder->section_index.emplace(string(section),
+                                               static_cast<uint32_t>(builder->sections.size()));
+            if (sec.second)
+            {
+                builder->sections.push_back(BuildSection());
+                builder->sections.back().name.assign(section);
+            }
+            builder->current = sec.first->second;
+        }
+        builder->sections[builder->current].entries.push_back(ins.first->second);
+        builder->entries.push_back(BuildEntry());
+        builder->entries.back().name.assign(key, entry->section_len + 1, string::npos);
+    }
+    string& stored = builder->entries[ins.first->second].value;
+    if (stored.size() > 0)
+        stored += "\n";
+    if (entry->value)
+        stored.append(entry->value, entry->value_len);
+    return 1;
+}
+
+}  // namespace
+
+struct INICache::Header
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint64_t options;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t source_hash;
+    uint64_t image_size;
+    uint64_t seed;
+    uint32_t entry_count;
+    uint32_t section_count;
+    uint32_t group_count;
+    uint32_t slot_count;
+    uint64_t pool_size;
+};
+
+// The value is stored right after the name's NUL terminator
+struct INICache::Entry
+{
+    uint32_t section;           // Index into the section table
+    uint32_t name_off;
+    uint32_t name_len;
+    uint32_t value_len;
+};
+
+struct INICache::Section
+{
+    uint32_t name_off;
+    uint32_t name_len;
+    uint32_t first;
+    uint32_t count;
+};
+
+// Byte offsets of each table, derived from the header counts
+struct INICache::Layout
+{
+    explicit Layout(const Header& h)
+    {
+        entries = sizeof(Header);
+        sections = entries + uint64_t(h.entry_count) * sizeof(Entry);
+        disp = sections + uint64_t(h.section_count) * sizeof(Section);
+        slots = disp + uint64_t(h.group_count) * sizeof(uint32_t);
+        pool = slots + uint64_t(h.slot_count) * sizeof(uint32_t);
+        size = pool + h.pool_size;
+    }
+
+    uint64_t entries;
+    uint64_t sections;
+    uint64_t disp;
+    uint64_t slots;
+    uint64_t pool;
+    uint64_t size;
+};
+
+INICache::INICache(const string& filename, const string& cache_filename)
+    : _error(0), _from_cache(false), _image(nullptr), _image_size(0), _map(nullptr),
+      _header(nullptr), _entries(nullptr), _sections(nullptr), _disp(nullptr),
+      _slots(nullptr), _pool(nullptr)
+{
+    const string cache = cache_filename.empty() ? filename + ".cache" : cache_filename;
+
+    SourceFile source;
+    if (!source.Open(filename))
+    {
+        _error = -1;
+        return;
+    }
+
+    // Hashing the source is still far cheaper than parsing it and building
+    // the index, and it catches edits that keep the same size and mtime
+    bool mapped = LoadCache(cache, source.size, source.mtime);
+    uint64_t hash = ContentHash(source.data, source.size);
+    if (mapped && _header->source_hash == hash)
+    {
+        _from_cache = true;
+        return;
+    }
+
+    Release();
+    Build(source.data, source.size, source.mtime, hash);
+    if (_error == 0)
+        WriteCache(cache);
+}
+
+INICache::~INICache()
+{
+    Release();
+}
+
+int INICache::ParseError() const
+{
+    return _error;
+}
+
+bool INICache::FromCache() const
+{
+    return _from_cache;
+}
+
+void INICache::Attach()
+{
+    Layout layout(*reinterpret_cast<const Header*>(_image));
+    _header = reinterpret_cast<const Header*>(_image);
+    _entries = reinterpret_cast<const Entry*>(_image + layout.entries);
+    _sections = reinterpret_cast<const Section*>(_image + layout.sections);
+    _disp = reinterpret_cast<const uint32_t*>(_image + layout.disp);
+    _slots = reinterpret_cast<const uint32_t*>(_image + layout.slots);
+    _pool = _image + layout.pool;
+}
+
+void INICache::Release()
+{
+#if INI_USE_MMAP
+    if (_map)
+        munmap(_map, _image_size);
+#endif
+    _map = nullptr;
+    _owned.clear();
+    _image = nullptr;
+    _image_size = 0;
+    _header = nullptr;
+}
+
+bool INICache::LoadCache(const string& cache_filename, uint64_t size, int64_t mtime)
+{
+#if INI_USE_MMAP
+    int fd = open(cache_filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || static_cast<uint64_t>(sb.st_size) < sizeof(Header))
+    {
+        close(fd);
+        return false;
+    }
+    size_t image_size = static_cast<size_t>(sb.st_size);
+    void* map = mmap(NULL, image_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    _map = map;
+    _image = static_cast<const char*>(map);
+    _image_size = image_size;
+#else
+    FILE* file = fopen(cache_filename.c_str(), "rb");
+    if (!file)
+        return false;
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (file_size < static_cast<long>(sizeof(Header)))
+    {
+        fclose(file);
+        return false;
+    }
+    _owned.assign((static_cast<size_t>(file_size) + 7) / 8, 0);
+    size_t n = fread(_owned.data(), 1, static_cast<size_t>(file_size), file);
+    fclose(file);
+    _image = reinterpret_cast<const char*>(_owned.data());
+    _image_size = static_cast<size_t>(file_size);
+    if (n != _image_size)
+    {
+        Release();
+        return false;
+    }
+#endif
+
+    // Reject images written by another version, byte order or parser
+    // configuration, and anything whose tables don't fit the file
+    const Header& h = *reinterpret_cast<const Header*>(_image);
+    Layout layout(h);
+    bool valid = memcmp(h.magic, kMagic, sizeof(kMagic)) == 0 &&
+                 h.version == kVersion && h.endian == kEndian &&
+                 h.options == OptionsHash() &&
+                 h.source_size == size && h.source_mtime == mtime &&
+                 h.image_size == _image_size && layout.size == _image_size &&
+                 h.slot_count >= h.entry_count && h.group_count > 0 &&
+                 h.pool_size <= 0xffffffffu;
+    if (!valid)
+    {
+        Release();
+        return false;
+    }
+    Attach();
+    if (!CheckTables())
+    {
+        Release();
+        return false;
+    }
+    return true;
+}
+
+// Check every offset the lookups follow, once, so that a damaged image that
+// got past the header checks is rejected instead of read out of bounds:
+// names and values must lie inside the pool and be NUL-terminated, and the
+// slots, sections and entries must refer to each other within range
+bool INICache::CheckTables() const
+{
+    const Header& h = *_header;
+    auto terminated = [&](uint64_t off, uint64_t len) {
+        return off + len < h.pool_size && _pool[off + len] == '\0';
+    };
+    for (uint32_t i = 0; i < h.section_count; i++)
+    {
+        const Section& s = _sections[i];
+        if (!terminated(s.name_off, s.name_len) || uint64_t(s.first) + s.count > h.entry_count)
+            return false;
+    }
+    for (uint32_t i = 0; i < h.entry_count; i++)
+    {
+        const Entry& e = _entries[i];
+        if (e.section >= h.section_count || !terminated(e.name_off, e.name_len) ||
+            !terminated(uint64_t(e.name_off) + e.name_len + 1, e.value_len))
+            return false;
+    }
+    for (uint32_t i = 0; i < h.slot_count; i++)
+    {
+        if (_slots[i] != kEmpty && _slots[i] >= h.entry_count)
+            return false;
+    }
+    return true;
+}
+
+void INICache::Build(const char* data, size_t size, int64_t mtime, uint64_t hash)
+{
+    Builder builder;
+    _error = ini_parse_string_length_ex(data, size, BuildHandler, &builder);
+    builder.index.clear();
+
+    // Sort the (few) sections by name, then each section's entries by name
+    const std::vector<BuildEntry>& entries = builder.entries;
+    std::vector<BuildSection>& build_sections = builder.sections;
+    if (entries.size() >= kEmpty)
+    {
+        _error = -2;
+        return;
+    }
+    std::sort(build_sections.begin(), build_sections.end(),
+              [](const BuildSection& a, const BuildSection& b) { return a.name < b.name; });
+
+    // Intern section names and lay out the string pool
+    std::vector<Section> sections(build_sections.size());
+    std::vector<Entry> records;
+    records.reserve(entries.size());
+    string pool;
+    for (size_t i = 0; i < build_sections.size(); i++)
+    {
+        BuildSection& bs = build_sections[i];
+        std::sort(bs.entries.begin(), bs.entries.end(), [&entries](uint32_t a, uint32_t b) {
+            return entries[a].name < entries[b].name;
+        });
+
+        Section& s = sections[i];
+        s.name_off = static_cast<uint32_t>(pool.size());
+        s.name_len = static_cast<uint32_t>(bs.name.size());
+        s.first = static_cast<uint32_t>(records.size());
+        s.count = static_cast<uint32_t>(bs.entries.size());
+        pool.append(bs.name).push_back('\0');
+        for (uint32_t index : bs.entries)
+        {
+            const BuildEntry& e = entries[index];
+            Entry r;
+            r.section = static_cast<uint32_t>(i);
+            r.name_off = static_cast<uint32_t>(pool.size());
+            r.name_len = static_cast<uint32_t>(e.name.size());
+            r.value_len = static_cast<uint32_t>(e.value.size());
+            pool.append(e.name).push_back('\0');
+            pool.append(e.value).push_back('\0');
+            records.push_back(r);
+        }
+        if (pool.size() > 0xffffffffu)
+        {
+            _error = -2;
+            return;
+        }
+    }
+    builder = Builder();
+
+    // Hash-and-displace perfect hash: about four keys per group, 80% load
+    uint32_t n = static_cast<uint32_t>(records.size());
+    uint32_t group_count = n / 4 + 1;
+    uint32_t slot_count = n + n / 4 + 1;
+    std::vector<uint32_t> disp(group_count);
+    std::vector<uint32_t> slots(slot_count);
+    std::vector<uint64_t> hashes(n);
+    uint64_t seed = 0;
+    bool built = false;
+    for (int attempt = 0; attempt < kMaxSeeds && !built; attempt++)
+    {
+        seed = static_cast<uint64_t>(attempt);
+        std::vector<std::vector<uint32_t>> groups(group_count);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            const Entry& r = records[i];
+            const Section& s = sections[r.section];
+            hashes[i] = KeyHash(string_view(pool.data() + s.name_off, s.name_len),
+                                string_view(pool.data() + r.name_off, r.name_len), seed);
+            groups[Reduce(static_cast<uint32_t>(hashes[i] >> 32), group_count)].push_back(i);
+        }
+        // Place the biggest groups first, while most slots are still free
+        std::vector<uint32_t> order(group_count);
+        for (uint32_t g = 0; g < group_count; g++)
+            order[g] = g;
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return groups[a].size() > groups[b].size();
+        });
+
+        std::fill(slots.begin(), slots.end(), kEmpty);
+        std::fill(disp.begin(), disp.end(), 0);
+        std::vector<uint32_t> placed;
+        built = true;
+        for (uint32_t g : order)
+        {
+            const std::vector<uint32_t>& group = groups[g];
+            if (group.empty())
+                break;
+            uint32_t d = 0;
+            for (; d < kMaxDisplacement; d++)
+            {
+                placed.clear();
+                for (uint32_t i : group)
+                {
+                    uint32_t s = Slot(hashes[i], d, slot_count);
+                    if (slots[s] != kEmpty)
+                        break;
+                    slots[s] = i;
+                    placed.push_back(s);
+                }
+                if (placed.size() == group.size())
+                    break;
+                for (uint32_t s : placed)
+                    slots[s] = kEmpty;
+            }
+            if (d == kMaxDisplacement)
+            {
+                built = false;
+                break;
+            }
+            disp[g] = d;
+        }
+    }
+    if (!built)
+    {
+        _error = -2;
+        return;
+    }
+
+    Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kVersion;
+    h.endian = kEndian;
+    h.options = OptionsHash();
+    h.source_size = size;
+    h.source_mtime = mtime;
+    h.source_hash = hash;
+    h.seed = seed;
+    h.entry_count = n;
+    h.section_count = static_cast<uint32_t>(sections.size());
+    h.group_count = group_count;
+    h.slot_count = slot_count;
+    h.pool_size = pool.size();
+    Layout layout(h);
+    h.image_size = layout.size;
+
+    _owned.assign((layout.size + 7) / 8, 0);
+    char* image = reinterpret_cast<char*>(_owned.data());
+    memcpy(image, &h, sizeof(h));
+    if (n > 0)
+        memcpy(image + layout.entries, records.data(), n * sizeof(Entry));
+    if (!sections.empty())
+        memcpy(image + layout.sections, sections.data(), sections.size() * sizeof(Section));
+    memcpy(image + layout.disp, disp.data(), group_count * sizeof(uint32_t));
+    memcpy(image + layout.slots, slots.data(), slot_count * sizeof(uint32_t));
+    if (!pool.empty())
+        memcpy(image + layout.pool, pool.data(), pool.size());
+
+    _image = image;
+    _image_size = static_cast<size_t>(layout.size);
+    Attach();
+}
+
+void INICache::WriteCache(const string& cache_filename) const
+{
+    // Write to a unique temporary file and rename it into place, so that
+    // processes starting at the same time never see a partial image
+#if INI_USE_MMAP
+    string tmp = cache_filename + ".XXXXXX";
+    int fd = mkstemp(&tmp[0]);
+    if (fd < 0)
+        return;
+    fchmod(fd, 0644);  // mkstemp creates 0600; other users' workers read it too
+    FILE* file = fdopen(fd, "wb");
+    if (!file)
+    {
+        close(fd);
+        unlink(tmp.c_str());
+        return;
+    }
+#else
+    string tmp = cache_filename + ".tmp";
+    FILE* file = fopen(tmp.c_str(), "wb");
+    if (!file)
+        return;
+#endif
+    bool ok = fwrite(_image, 1, _image_size, file) == _image_size;
+    ok = fclose(file) == 0 && ok;
+    if (ok && rename(tmp.c_str(), cache_filename.c_str()) != 0)
+    {
+        // Windows won't rename over an existing file
+        remove(cache_filename.c_str());
+        ok = rename(tmp.c_str(), cache_filename.c_str()) == 0;
+    }
+    if (!ok)
+        remove(tmp.c_str());
+}
+
+const INICache::Entry* INICache::Find(string_view section, string_view name) const
+{
+    if (!_header || _header->entry_count == 0)
+        return nullptr;
+
+    uint64_t hash = KeyHash(section, name, _header->seed);
+    uint32_t d = _disp[Reduce(static_cast<uint32_t>(hash >> 32), _header->group_count)];
+    uint32_t i = _slots[Slot(hash, d, _header->slot_count)];
+    if (i == kEmpty)
+        return nullptr;
+
+    // Keys that aren't in the file also land on some slot, so compare. The
+    // offsets were checked when the image was loaded (CheckTables())
+    const Entry* e = _entries + i;
+    const Section& s = _sections[e->section];
+    if (CompareLower(section, _pool + s.name_off, s.name_len) != 0 ||
+        CompareLower(name, _pool + e->name_off, e->name_len) != 0)
+        return nullptr;
+    return e;
+}
+
+const INICache::Section* INICache::FindSection(string_view section) const
+{
+    if (!_header)
+        return nullptr;
+    const Section* first = _sections;
+    const Section* last = _sections + _header->section_count;
+    const Section* it = std::lower_bound(first, last, section, [this](const Section& s, string_view q) {
+        return CompareLower(q, _pool + s.name_off, s.name_len) > 0;
+    });
+    if (it == last || CompareLower(section, _pool + it->name_off, it->name_len) != 0)
+        return nullptr;
+    return it;
+}
+
+const char* INICache::ValueOf(const Entry* e) const
+{
+    return _pool + e->name_off + e->name_len + 1;
+}
+
+template <class T, class Parse>
+T INICache::Typed(string_view section, string_view name, T default_value, Parse parse) const
+{
+    const Entry* e = Find(section, name);
+    T n;
+    return e && parse(string_view(ValueOf(e), e->value_len), &n) ? n : default_value;
+}
+
+string_view INICache::GetView(string_view section, string_view name, string_view default_value) const
+{
+    const Entry* e = Find(section, name);
+    return e ? string_view(ValueOf(e), e->value_len) : default_value;
+}
+
+string INICache::Get(string_view section, string_view name, const string& default_value) const
+{
+    const Entry* e = Find(section, name);
+    return e ? string(ValueOf(e), e->value_len) : default_value;
+}
+
+string INICache::GetString(string_view section, string_view name, const string& default_value) const
+{
+    string_view str = GetView(section, name, string_view());
+    return str.empty() ? default_value : string(str);
+}
+
+// The typed getters use INIReader's parsers (INIText.h), so both classes
+// accept the same values and convert them the same way
+
+long INICache::GetInteger(string_view section, string_view name, long default_value) const
+{
+    return Typed(section, name, default_value, [](string_view value, long* n) { return ParseInteger(value, n); });
+}
+
+int64_t INICache::GetInteger64(string_view section, string_view name, int64_t default_value) const
+{
+    return Typed(section, name, default_value, [](string_view value, int64_t* n) { return ParseInteger(value, n); });
+}
+
+unsigned long INICache::GetUnsigned(string_view section, string_view name, unsigned long default_value) const
+{
+    return Typed(section, name, default_value,
+                 [](string_view value, unsigned long* n) { return ParseInteger(value, n); });
+}
+
+uint64_t INICache::GetUnsigned64(string_view section, string_view name, uint64_t default_value) const
+{
+    return Typed(section, name, default_value, [](string_view value, uint64_t* n) { return ParseInteger(value, n); });
+}
+
+double INICache::GetReal(string_view section, string_view name, double default_value) const
+{
+    // Values in the pool are NUL-terminated, as ParseReal()'s fallback needs
+    return Typed(section, name, default_value, [](string_view value, double* n) { return ParseReal(value, n); });
+}
+
+bool INICache::GetBoolean(string_view section, string_view name, bool default_value) const
+{
+    return Typed(section, name, default_value, [](string_view value, bool* b) { return ParseBoolean(value, b); });
+}
+
+std::vector<string> INICache::Sections() const
+{
+    std::vector<string> names;
+    if (!_header)
+        return names;
+    names.reserve(_header->section_count);
+    for (uint32_t i = 0; i < _header->section_count; i++)
+        names.emplace_back(_pool + _sections[i].name_off, _sections[i].name_len);
+    return names;
+}
+
+std::vector<string> INICache::Keys(string_view section) const
+{
+    std::vector<string> keys;
+    const Section* s = FindSection(section);
+    if (!s)
+        return keys;
+    keys.reserve(s->count);
+    for (uint32_t i = s->first; i < s->first + s->count; i++)
+        keys.emplace_back(_pool + _entries[i].name_off, _entries[i].name_len);
+    return keys;
+}
+
+bool INICache::HasSection(string_view section) const
+{
+    return FindSection(section) != nullptr;
+}
+
+bool INICache::HasValue(string_view section, string_view name) const
+{
+    return Find(section, name) != nullptr;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file INILayeredReader.cpp
+ * @brief 多层INI配置合并为一个索引
+ *
+ * @copyright Copyright (C) 2009-2025, Ben Hoyt
+ * @license SPDX-License-Identifier: BSD-3-Clause
+ *
+ * 按优先级从低到高依次解析各层（文件或内存文本），全部写入同一个INIReader索引：
+ * 键第一次出现时照常新建条目，之后在更高的层再次出现时直接替换条目的值，
+ * 并记下值来自哪一层；同一层内的重复键和续行仍按INIReader的规则拼接。
+ * 优先级在构建时就已决定，因此查找只需探测一次哈希表，与层数无关。
+ * 被替换的旧值仍留在arena中，不再被引用。
+ *
+ * 项目主页：https://github.com/benhoyt/inih
+ */
+
+#include "ini.h"
+#include "INILayeredReader.h"
+
+using std::string;
+using std::string_view;
+
+INILayeredReader::INILayeredReader(const std::vector<Source>& sources)
+    : _current(0)
+{
+    Parse(sources);
+}
+
+INILayeredReader::INILayeredReader(const std::vector<string>& filenames)
+    : _current(0)
+{
+    std::vector<Source> sources;
+    sources.reserve(filenames.size());
+    for (const string& filename : filenames)
+        sources.push_back(Source::File(filename));
+    Parse(sources);
+}
+
+void INILayeredReader::Parse(const std::vector<Source>& sources)
+{
+    _layer_errors.reserve(sources.size());
+    for (const Source& source : sources)
+    {
+        // LayerHandler() passes user on to INIReader::ValueHandler(), which
+        // casts it back to INIReader*, so that's the type it goes in as
+        void* user = static_cast<INIReader*>(this);
+        int error = source.is_file
+            ? ini_parse_ex(source.filename.c_str(), LayerHandler, user)
+            : ini_parse_string_length_ex(source.text.data(), source.text.size(), LayerHandler, user);
+        _layer_errors.push_back(error);
+        if (error != 0 && _error == 0)
+            _error = error;
+        _current++;
+    }
+    Finish();
+    if (_layers.capacity() - _layers.size() > _layers.size() / 8)
+        _layers.shrink_to_fit();
+}
+
+int INILayeredReader::Layer(string_view section, string_view name) const
+{
+    const Entry* entry = Find(section, name);
+    return entry ? static_cast<int>(_layers[entry - _entries.data()]) : -1;
+}
+
+int INILayeredReader::Layer(Handle key) const
+{
+    const Entry* entry = Find(key);
+    return entry ? static_cast<int>(_layers[entry - _entries.data()]) : -1;
+}
+
+int INILayeredReader::LayerHandler(void* user, const ini_entry* entry)
+{
+    if (!entry->name)  // Happens when INI_CALL_HANDLER_ON_NEW_SECTION enabled
+        return 1;
+
+    INILayeredReader* reader = static_cast<INILayeredReader*>(static_cast<INIReader*>(user));
+    string_view section(entry->section, entry->section_len);
+    string_view name(entry->name, entry->name_len);
+    Entry* stored = const_cast<Entry*>(reader->Find(section, name));
+    size_t index = stored ? static_cast<size_t>(stored - reader->_entries.data()) : 0;
+
+    // A key set by a lower layer takes this layer's value instead; a
+    // MultiValue it had is simply no longer referred to
+    if (stored && reader->_layers[index] != reader->_current)
+    {
+        string_view value(entry->value ? entry->value : "", entry->value ? entry->value_len : 0);
+        if (reader->_arena.size() + value.size() + 1 > UINT32_MAX)  // Offsets are 32 bits
+            return 0;
+        stored->value = reader->Intern(value, false);
+        stored->value_size = static_cast<uint32_t>(value.size());
+        stored->multi = 0;
+        reader->_layers[index] = reader->_current;
+        return 1;
+    }
+
+    size_t count = reader->_entries.size();
+    int result = ValueHandler(user, entry);
+    if (reader->_entries.size() > count)
+        reader->_layers.push_back(reader->_current);
+    return result;
+}
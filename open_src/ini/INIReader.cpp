@@ -26,21 +26,413 @@
  */
 
 #include <algorithm>
-#include <cctype>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include <utility>
 #include "ini.h"
 #include "INIReader.h"
+#include "INIText.h"
+
+#if INI_READER_STATS
+#include <map>
+#include <thread>
+#include <unordered_map>
+#endif
+
+#if INI_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 using std::string;
+using std::string_view;
+using namespace ini_text;
+
+namespace
+{
+
+#if INI_READER_STATS
+string ToLower(string_view s)
+{
+    string lower(s);
+    for (char& ch : lower)
+        ch = LowerChar(ch);
+    return lower;
+}
+#endif
+
+// Linear probing over a power-of-two slot table. Return the position of the
+// slot whose item match() accepts, or of the empty slot that ends the probe
+template <class SlotT, class Match>
+size_t Probe(const std::vector<SlotT>& slots, uint64_t hash, Match match)
+{
+    size_t mask = slots.size() - 1;
+    uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t i = static_cast<size_t>(hash) & mask; ; i = (i + 1) & mask)
+    {
+        const SlotT& slot = slots[i];
+        if (slot.index == 0 || (slot.tag == tag && match(slot.index - 1)))
+            return i;
+    }
+}
+
+template <class SlotT>
+void Place(std::vector<SlotT>& slots, uint64_t hash, size_t index)
+{
+    size_t mask = slots.size() - 1;
+    size_t i = static_cast<size_t>(hash) & mask;
+    while (slots[i].index != 0)
+        i = (i + 1) & mask;
+    slots[i].tag = static_cast<uint32_t>(hash >> 32);
+    slots[i].index = static_cast<uint32_t>(index + 1);
+}
+
+// Index the item just appended to items, growing the table to keep the
+// load factor at or below 3/4
+template <class SlotT, class Item>
+void AddSlot(std::vector<SlotT>& slots, const std::vector<Item>& items)
+{
+    if (items.size() * 4 > slots.size() * 3)
+    {
+        size_t size = slots.empty() ? 16 : slots.size() * 2;
+        slots.assign(size, SlotT());
+        for (size_t i = 0; i < items.size(); i++)
+            Place(slots, items[i].hash, i);
+    }
+    else
+    {
+        Place(slots, items.back().hash, items.size() - 1);
+    }
+}
+
+inline void Prefetch(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#else
+    (void)p;
+#endif
+}
+
+// Sort names as views, so that only the results are copied into strings
+std::vector<string> SortedCopy(std::vector<string_view>& names)
+{
+    std::sort(names.begin(), names.end());
+    return std::vector<string>(names.begin(), names.end());
+}
+
+// Map filename, or read it into memory where mmap isn't available or
+// fails. The returned pointer owns the text; null if the file can't be read.
+// The mapping is MAP_PRIVATE, which doesn't protect it from the file being
+// truncated or rewritten in place (see Mode::kLazy in INIReader.h)
+std::shared_ptr<const char> ReadSource(const string& filename, size_t* size)
+{
+#if INI_USE_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat sb;
+    if (fstat(fd, &sb) == 0 && sb.st_size > 0)
+    {
+        size_t length = static_cast<size_t>(sb.st_size);
+        void* map = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+            close(fd);
+            *size = length;
+            return std::shared_ptr<const char>(static_cast<const char*>(map), [length](const char* p) {
+                munmap(const_cast<char*>(p), length);
+            });
+        }
+    }
+    close(fd);
+#endif
+    FILE* file = fopen(filename.c_str(), "rb");
+    if (!file)
+        return nullptr;
+    std::shared_ptr<string> text = std::make_shared<string>();
+    char block[65536];
+    size_t n;
+    while ((n = fread(block, 1, sizeof(block), file)) > 0)
+        text->append(block, n);
+    fclose(file);
+    *size = text->size();
+    return std::shared_ptr<const char>(text, text->data());
+}
+
+}  // namespace
+
+// Joined values, and values copied out of the source in kLazy mode. Blocks
+// are only freed with the store, so a value stays where it was copied once
+// it is published
+struct INIReader::ValueStore
+{
+    static const size_t kBlockSize = 4096;
+
+    ValueStore() : next(nullptr), left(0), bytes(0) {}
+
+    // Caller holds mutex
+    char* Allocate(size_t size)
+    {
+        if (size > kBlockSize / 4)
+        {
+            blocks.emplace_back(new char[size]);
+            bytes += size;
+            return blocks.back().get();
+        }
+        if (size > left)
+        {
+            blocks.emplace_back(new char[kBlockSize]);
+            bytes += kBlockSize;
+            next = blocks.back().get();
+            left = kBlockSize;
+        }
+        char* p = next;
+        next += size;
+        left -= size;
+        return p;
+    }
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* next;         // Free space in the current block
+    size_t left;
+    size_t bytes;       // Sum of the block sizes
+};
+
+#if INI_READER_STATS
+// Access counts. Every thread that reads gets its own shard and only ever
+// writes to that, so counting is a plain load and store to cache lines no
+// other thread writes, and readers on different cores never share a line.
+// A thread finds its shards through a thread_local map from log id to
+// shard, in front of which it keeps the last few it used, so it only takes
+// the log's mutex the first time it reads through a log, however many
+// readers it alternates between. Ids are never reused,
+// so an entry left behind by a destroyed log can't match; such entries are
+// dropped whenever the thread adds one. AccessReport() adds the shards up.
+// A thread's shard outlives it, and is taken over by a later thread given
+// the same std::thread::id.
+struct INIReader::AccessLog : std::enable_shared_from_this<AccessLog>
+{
+    struct alignas(64) Line
+    {
+        std::atomic<uint64_t> counts[8];
+    };
+
+    struct alignas(64) Shard
+    {
+        explicit Shard(size_t entries)
+            : owner(std::this_thread::get_id()), lines(new Line[(2 * entries + 7) / 8]())
+        {
+        }
+
+        // Reads and fallbacks of entry i are counts 2i and 2i + 1
+        std::atomic<uint64_t>& Count(size_t i) { return lines[i / 8].counts[i % 8]; }
+
+        std::thread::id owner;
+        std::unique_ptr<Line[]> lines;
+        std::mutex mutex;       // Guards misses
+        std::map<std::pair<string, string>, uint64_t> misses;
+    };
+
+    explicit AccessLog(size_t entries) : id(NextId()++), entries(entries) {}
+
+    static std::atomic<uint64_t>& NextId()
+    {
+        static std::atomic<uint64_t> next(1);
+        return next;
+    }
+
+    // The last few shards a thread used. Trivial, so that reaching it from
+    // the shared library costs no more than the TLS lookup
+    struct RecentShards
+    {
+        static const size_t kSize = 4;
+        uint64_t ids[kSize];
+        Shard* shards[kSize];
+        size_t next;
+    };
+
+    // Every shard a thread has, by log id
+    struct KnownShard
+    {
+        std::weak_ptr<AccessLog> log;   // Expired once the log is gone
+        Shard* shard;
+    };
+
+    Shard& Local()
+    {
+        static thread_local RecentShards recent;
+        for (size_t i = 0; i < RecentShards::kSize; i++)
+        {
+            if (recent.ids[i] == id)
+                return *recent.shards[i];
+        }
+        static thread_local std::unordered_map<uint64_t, KnownShard> known;
+        auto found = known.find(id);
+        if (found == known.end())
+        {
+            for (auto it = known.begin(); it != known.end(); )
+                it = it->second.log.expired() ? known.erase(it) : std::next(it);
+            found = known.emplace(id, KnownShard{weak_from_this(), Attach()}).first;
+        }
+        recent.ids[recent.next] = id;
+        recent.shards[recent.next] = found->second.shard;
+        recent.next = (recent.next + 1) % RecentShards::kSize;
+        return *found->second.shard;
+    }
+
+    // This thread's shard, made on its first read through the log
+    Shard* Attach()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::thread::id self = std::this_thread::get_id();
+        for (const std::unique_ptr<Shard>& shard : shards)
+        {
+            if (shard->owner == self)
+                return shard.get();
+        }
+        shards.emplace_back(new Shard(entries));
+        return shards.back().get();
+    }
+
+    static void Add(std::atomic<uint64_t>& count)
+    {
+        count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    const uint64_t id;
+    const size_t entries;
+    std::mutex mutex;       // Guards shards
+    std::vector<std::unique_ptr<Shard>> shards;
+};
+
+bool INIReader::Counted(const Entry& entry, bool converted) const
+{
+    if (_access)
+    {
+        AccessLog::Shard& shard = _access->Local();
+        size_t index = static_cast<size_t>(&entry - _entries.data());
+        AccessLog::Add(shard.Count(2 * index));
+        if (!converted)
+            AccessLog::Add(shard.Count(2 * index + 1));
+    }
+    return converted;
+}
+
+void INIReader::CountMiss(string_view section, string_view name) const
+{
+    if (!_access)
+        return;
+    AccessLog::Shard& shard = _access->Local();
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.misses[std::make_pair(ToLower(section), ToLower(name))]++;
+}
+#else
+bool INIReader::Counted(const Entry&, bool converted) const
+{
+    return converted;
+}
+
+void INIReader::CountMiss(string_view, string_view) const
+{
+}
+#endif
 
 INIReader::INIReader(const string& filename)
+    : INIReader(filename, Mode::kEager)
 {
-    _error = ini_parse(filename.c_str(), ValueHandler, this);
 }
 
 INIReader::INIReader(const char *buffer, size_t buffer_size)
+    : INIReader(buffer, buffer_size, Mode::kEager)
+{
+}
+
+INIReader::INIReader(const string& filename, Mode mode)
+    : _lazy(false), _source(nullptr), _source_size(0)
+{
+    if (mode == Mode::kEager)
+    {
+        _error = ini_parse_ex(filename.c_str(), ValueHandler, this);
+        Finish();
+        return;
+    }
+    size_t size = 0;
+    _source_owner = ReadSource(filename, &size);
+    if (!_source_owner)
+    {
+        _error = -1;
+        return;
+    }
+    Load(_source_owner.get(), size, Mode::kLazy);
+}
+
+INIReader::INIReader(const char *buffer, size_t buffer_size, Mode mode)
+    : _lazy(false), _source(nullptr), _source_size(0)
+{
+    Load(buffer, buffer_size, mode);
+}
+
+INIReader::INIReader(AdoptTag, string&& text)
+    : _lazy(false), _source(nullptr), _source_size(0)
+{
+    std::shared_ptr<string> owned = std::make_shared<string>(std::move(text));
+    _source_owner = std::shared_ptr<const char>(owned, owned->data());
+    Adopt(owned->data(), owned->size());
+}
+
+INIReader::INIReader(AdoptTag, std::vector<char>&& text)
+    : _lazy(false), _source(nullptr), _source_size(0)
+{
+    std::shared_ptr<std::vector<char>> owned = std::make_shared<std::vector<char>>(std::move(text));
+    _source_owner = std::shared_ptr<const char>(owned, owned->data());
+    Adopt(owned->data(), owned->size());
+}
+
+static_assert(std::is_nothrow_move_constructible<INIReader>::value &&
+              std::is_nothrow_move_assignable<INIReader>::value,
+              "moving an INIReader must not copy or throw");
+
+void INIReader::Load(const char* buffer, size_t buffer_size, Mode mode)
+{
+    if (mode == Mode::kLazy)
+    {
+        _lazy = true;
+        _source = buffer;
+        _source_size = buffer_size;
+        _store = std::make_shared<ValueStore>();
+    }
+    else
+    {
+        // The strings take at most about as much room as the text they came
+        // from, so the arena is normally allocated once
+        _arena.reserve(buffer_size + 1);
+    }
+    _error = ini_parse_string_length_ex(buffer, buffer_size, ValueHandler, this);
+    Finish();
+}
+
+// Index text the reader owns, then end each single-line value with a NUL
+// in place so that Materialize() can hand it out without copying. The byte
+// after a value is trailing whitespace, the start of a comment or the line
+// break, which nothing else refers to once the parser is done; a value
+// running to the very end of the text is copied when read instead
+void INIReader::Adopt(char* text, size_t size)
 {
-  _error = ini_parse_string_length(buffer, buffer_size, ValueHandler, this);
+    Load(text, size, Mode::kLazy);
+    for (size_t i = 0; i < _entries.size(); i++)
+    {
+        const Entry& entry = _entries[i];
+        size_t end = static_cast<size_t>(entry.value) + entry.value_size;
+        if (!entry.multi && entry.value_size > 0 && end < size)
+            text[end] = '\0';
+    }
 }
 
 int INIReader::ParseError() const
@@ -48,150 +440,643 @@ int INIReader::ParseError() const
     return _error;
 }
 
-string INIReader::Get(const string& section, const string& name, const string& default_value) const
+string INIReader::Get(string_view section, string_view name, const string& default_value) const
 {
-    string key = MakeKey(section, name);
-    // Use _values.find() here instead of _values.at() to support pre C++11 compilers
-    return _values.count(key) ? _values.find(key)->second : default_value;
+    return Get(Resolve(section, name), default_value);
 }
 
-string INIReader::GetString(const string& section, const string& name, const string& default_value) const
+string_view INIReader::GetView(string_view section, string_view name, string_view default_value) const
 {
-    const string str = Get(section, name, "");
-    return str.empty() ? default_value : str;
+    return GetView(Resolve(section, name), default_value);
 }
 
-long INIReader::GetInteger(const string& section, const string& name, long default_value) const
+string INIReader::GetString(string_view section, string_view name, const string& default_value) const
 {
-    string valstr = Get(section, name, "");
-    const char* value = valstr.c_str();
-    char* end;
-    // This parses "1234" (decimal) and also "0x4D2" (hex)
-    long n = strtol(value, &end, 0);
-    return end > value ? n : default_value;
+    return GetString(Resolve(section, name), default_value);
 }
 
-INI_API int64_t INIReader::GetInteger64(const string& section, const string& name, int64_t default_value) const
+long INIReader::GetInteger(string_view section, string_view name, long default_value) const
 {
-    string valstr = Get(section, name, "");
-    const char* value = valstr.c_str();
-    char* end;
-    // This parses "1234" (decimal) and also "0x4D2" (hex)
-    int64_t n = strtoll(value, &end, 0);
-    return end > value ? n : default_value;
+    return GetInteger(Resolve(section, name), default_value);
 }
 
-unsigned long INIReader::GetUnsigned(const string& section, const string& name, unsigned long default_value) const
+INI_API int64_t INIReader::GetInteger64(string_view section, string_view name, int64_t default_value) const
 {
-    string valstr = Get(section, name, "");
-    const char* value = valstr.c_str();
-    char* end;
+    return GetInteger64(Resolve(section, name), default_value);
+}
+
+unsigned long INIReader::GetUnsigned(string_view section, string_view name, unsigned long default_value) const
+{
+    return GetUnsigned(Resolve(section, name), default_value);
+}
+
+INI_API uint64_t INIReader::GetUnsigned64(string_view section, string_view name, uint64_t default_value) const
+{
+    return GetUnsigned64(Resolve(section, name), default_value);
+}
+
+double INIReader::GetReal(string_view section, string_view name, double default_value) const
+{
+    return GetReal(Resolve(section, name), default_value);
+}
+
+bool INIReader::GetBoolean(string_view section, string_view name, bool default_value) const
+{
+    return GetBoolean(Resolve(section, name), default_value);
+}
+
+INIReader::ValueRange INIReader::GetAll(string_view section, string_view name) const
+{
+    return GetAll(Resolve(section, name));
+}
+
+INIReader::Handle INIReader::Resolve(string_view section, string_view name) const
+{
+    const Entry* entry = Find(section, name);
+    if (!entry)
+    {
+        CountMiss(section, name);
+        return Handle();
+    }
+    return Handle(static_cast<uint32_t>(entry - _entries.data()));
+}
+
+string INIReader::Get(Handle key, const string& default_value) const
+{
+    const Entry* entry = Find(key);
+    return entry && Counted(*entry, true) ? string(Value(*entry)) : default_value;
+}
+
+string_view INIReader::GetView(Handle key, string_view default_value) const
+{
+    const Entry* entry = Find(key);
+    return entry && Counted(*entry, true) ? Value(*entry) : default_value;
+}
+
+string INIReader::GetString(Handle key, const string& default_value) const
+{
+    const Entry* entry = Find(key);
+    return entry && Counted(*entry, true) && entry->value_size > 0 ? string(Value(*entry)) : default_value;
+}
+
+// Return the typed form of a value from cache, parsing it with parse() the
+// first time. parse() stores the result in *out and returns false if the
+// value isn't valid for the type
+template <class T, class Parse>
+bool INIReader::Cached(const Entry& entry, uint16_t parsed, T* out, Parse parse)
+{
+    uint16_t flags = entry.typed_flags.load(std::memory_order_acquire);
+    if (flags & parsed)
+    {
+        uint64_t bits = entry.typed_bits.load(std::memory_order_relaxed);
+        memcpy(out, &bits, sizeof(T));
+        return (flags & (parsed << 1)) != 0;
+    }
+    bool valid = parse(out);
+    uint16_t empty = 0;
+    if (flags == 0 && entry.typed_flags.compare_exchange_strong(empty, kBusy, std::memory_order_relaxed))
+    {
+        uint64_t bits = 0;
+        memcpy(&bits, out, sizeof(T));
+        entry.typed_bits.store(bits, std::memory_order_relaxed);
+        entry.typed_flags.store(static_cast<uint16_t>(valid ? parsed | (parsed << 1) : parsed),
+                                std::memory_order_release);
+    }
+    return valid;
+}
+
+// The typed getters parse the stored value in place and remember the
+// result, so repeated reads of a key as the same type don't parse it
+// again. long and unsigned long share the 64-bit cache when they are 64
+// bits wide; elsewhere they are parsed on every call so that overflow still
+// clamps to their own range.
+
+long INIReader::GetInteger(Handle key, long default_value) const
+{
+    if (sizeof(long) == sizeof(int64_t))
+        return static_cast<long>(GetInteger64(key, default_value));
+    const Entry* entry = Find(key);
+    long n;
     // This parses "1234" (decimal) and also "0x4D2" (hex)
-    unsigned long n = strtoul(value, &end, 0);
-    return end > value ? n : default_value;
+    return entry && Counted(*entry, ParseInteger(Value(*entry), &n)) ? n : default_value;
 }
 
-INI_API uint64_t INIReader::GetUnsigned64(const string& section, const string& name, uint64_t default_value) const
+int64_t INIReader::GetInteger64(Handle key, int64_t default_value) const
 {
-    string valstr = Get(section, name, "");
-    const char* value = valstr.c_str();
-    char* end;
+    const Entry* entry = Find(key);
+    int64_t n = 0;
+    return entry && Counted(*entry, ReadTyped(*entry, &n)) ? n : default_value;
+}
+
+unsigned long INIReader::GetUnsigned(Handle key, unsigned long default_value) const
+{
+    if (sizeof(unsigned long) == sizeof(uint64_t))
+        return static_cast<unsigned long>(GetUnsigned64(key, default_value));
+    const Entry* entry = Find(key);
+    unsigned long n;
     // This parses "1234" (decimal) and also "0x4D2" (hex)
-    uint64_t n = strtoull(value, &end, 0);
-    return end > value ? n : default_value;
+    return entry && Counted(*entry, ParseInteger(Value(*entry), &n)) ? n : default_value;
 }
 
-double INIReader::GetReal(const string& section, const string& name, double default_value) const
+uint64_t INIReader::GetUnsigned64(Handle key, uint64_t default_value) const
 {
-    string valstr = Get(section, name, "");
-    const char* value = valstr.c_str();
-    char* end;
-    double n = strtod(value, &end);
-    return end > value ? n : default_value;
+    const Entry* entry = Find(key);
+    uint64_t n = 0;
+    return entry && Counted(*entry, ReadTyped(*entry, &n)) ? n : default_value;
 }
 
-bool INIReader::GetBoolean(const string& section, const string& name, bool default_value) const
+double INIReader::GetReal(Handle key, double default_value) const
 {
-    string valstr = Get(section, name, "");
-    // Convert to lower case to make string comparisons case-insensitive
-    std::transform(valstr.begin(), valstr.end(), valstr.begin(),
-        [](const unsigned char& ch) { 
-            return static_cast<unsigned char>(::tolower(ch)); 
-        });
-    if (valstr == "true" || valstr == "yes" || valstr == "on" || valstr == "1")
-        return true;
-    else if (valstr == "false" || valstr == "no" || valstr == "off" || valstr == "0")
-        return false;
-    else
-        return default_value;
+    const Entry* entry = Find(key);
+    double n = 0;
+    return entry && Counted(*entry, ReadTyped(*entry, &n)) ? n : default_value;
 }
 
-std::vector<string> INIReader::Sections() const
+bool INIReader::GetBoolean(Handle key, bool default_value) const
+{
+    const Entry* entry = Find(key);
+    bool b = false;
+    return entry && Counted(*entry, ReadTyped(*entry, &b)) ? b : default_value;
+}
+
+// The typed form of a value, through the cache. Return false if the value
+// isn't valid for the type
+
+bool INIReader::ReadTyped(const Entry& entry, int64_t* out) const
+{
+    return Cached(entry, kInteger, out, [this, &entry](int64_t* n) {
+        // This parses "1234" (decimal) and also "0x4D2" (hex)
+        return ParseInteger(Value(entry), n);
+    });
+}
+
+bool INIReader::ReadTyped(const Entry& entry, uint64_t* out) const
+{
+    return Cached(entry, kUnsigned, out, [this, &entry](uint64_t* n) {
+        // This parses "1234" (decimal) and also "0x4D2" (hex)
+        return ParseInteger(Value(entry), n);
+    });
+}
+
+bool INIReader::ReadTyped(const Entry& entry, double* out) const
+{
+    return Cached(entry, kReal, out, [this, &entry](double* n) {
+        return ParseReal(Value(entry), n);
+    });
+}
+
+bool INIReader::ReadTyped(const Entry& entry, bool* out) const
+{
+    return Cached(entry, kBoolean, out, [this, &entry](bool* b) {
+        return ParseBoolean(Value(entry), b);
+    });
+}
+
+bool INIReader::HasValue(Handle key) const
 {
-    std::set<string> sectionSet;
-    for (std::map<string, string>::const_iterator it = _values.begin(); it != _values.end(); ++ it) 
+    const Entry* entry = Find(key);
+    return entry && Counted(*entry, true);
+}
+
+INIReader::ValueRange INIReader::GetAll(Handle key) const
+{
+    const Entry* entry = Find(key);
+    return entry && Counted(*entry, true) ? ValueRange(this, key._index) : ValueRange();
+}
+
+void INIReader::GetMany(const KeyRequest* requests, Result* results, size_t count) const
+{
+    // Batches small enough for their hashes and entries to stay in
+    // registers and L1, large enough to keep several misses in flight
+    const size_t kBatch = 16;
+    uint64_t hashes[kBatch];
+    const Entry* entries[kBatch];
+    size_t mask = _slots.size() - 1;
+
+    for (size_t base = 0; base < count; base += kBatch)
     {
-        size_t pos = it->first.find('=');
-        if (pos != string::npos) 
+        size_t n = std::min(kBatch, count - base);
+        const KeyRequest* batch = requests + base;
+        for (size_t i = 0; i < n; i++)
+        {
+            hashes[i] = KeyHash(batch[i].section, batch[i].name);
+            if (!_slots.empty())
+                Prefetch(&_slots[static_cast<size_t>(hashes[i]) & mask]);
+        }
+        // Each step only touches lines the previous one prefetched: the home
+        // slot, then the entry it most likely names, then that entry's name
+        // and value text, and only then the full lookups
+        for (size_t i = 0; i < n; i++)
         {
-            sectionSet.insert(it->first.substr(0, pos));
+            entries[i] = nullptr;
+            if (_slots.empty())
+                continue;
+            const Slot& slot = _slots[static_cast<size_t>(hashes[i]) & mask];
+            if (slot.index != 0 && slot.tag == static_cast<uint32_t>(hashes[i] >> 32))
+            {
+                entries[i] = &_entries[slot.index - 1];
+                Prefetch(entries[i]);
+            }
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            if (entries[i] && !_lazy && !entries[i]->multi)
+            {
+                Prefetch(_arena.data() + entries[i]->name);
+                Prefetch(_arena.data() + entries[i]->value);
+            }
+        }
+        for (size_t i = 0; i < n; i++)
+            entries[i] = Find(batch[i].section, batch[i].name, hashes[i]);
+        for (size_t i = 0; i < n; i++)
+        {
+            const Entry* entry = entries[i];
+            Result& result = results[base + i];
+            result.found = false;
+            if (!entry)
+            {
+                CountMiss(batch[i].section, batch[i].name);
+                continue;
+            }
+            switch (batch[i].type)
+            {
+            case KeyRequest::kString:
+                result.string = Value(*entry);
+                result.found = Counted(*entry, true);
+                break;
+            case KeyRequest::kInteger:
+            {
+                int64_t n64 = 0;
+                result.found = Counted(*entry, ReadTyped(*entry, &n64));
+                if (result.found)
+                    result.integer = n64;
+                break;
+            }
+            case KeyRequest::kUnsigned:
+            {
+                uint64_t u64 = 0;
+                result.found = Counted(*entry, ReadTyped(*entry, &u64));
+                if (result.found)
+                    result.unsigned_integer = u64;
+                break;
+            }
+            case KeyRequest::kReal:
+            {
+                double real = 0;
+                result.found = Counted(*entry, ReadTyped(*entry, &real));
+                if (result.found)
+                    result.real = real;
+                break;
+            }
+            case KeyRequest::kBoolean:
+            {
+                bool boolean = false;
+                result.found = Counted(*entry, ReadTyped(*entry, &boolean));
+                if (result.found)
+                    result.boolean = boolean;
+                break;
+            }
+            }
         }
     }
-    return std::vector<string>(sectionSet.begin(), sectionSet.end());
 }
 
-std::vector<string> INIReader::Keys(const string& section) const
+std::vector<string> INIReader::Sections() const
+{
+    std::vector<string_view> sections(SectionNames().begin(), SectionNames().end());
+    return SortedCopy(sections);
+}
+
+std::vector<string> INIReader::Keys(string_view section) const
 {
-    std::vector<string> keys;
-    string keyPrefix = MakeKey(section, "");
-    for (std::map<string, string>::const_iterator it = _values.begin(); it != _values.end(); ++it) 
+    std::vector<string_view> keys;
+    ItemRange items = Items(section);
+    keys.reserve(items.size());
+    for (Item item : items)
+        keys.push_back(item.name);
+    return SortedCopy(keys);
+}
+
+INIReader::ItemRange INIReader::Items(string_view section) const
+{
+    const Section* found = FindSection(section);
+    if (!found)
+        return ItemRange();
+    return ItemRange(this, _section_keys.data() + found->first_key, found->key_count);
+}
+
+bool INIReader::HasSection(string_view section) const
+{
+    return FindSection(section) != nullptr;
+}
+
+bool INIReader::HasValue(string_view section, string_view name) const
+{
+    return HasValue(Resolve(section, name));
+}
+
+const INIReader::Entry* INIReader::Find(string_view section, string_view name) const
+{
+    return Find(section, name, KeyHash(section, name));
+}
+
+const INIReader::Entry* INIReader::Find(string_view section, string_view name, uint64_t hash) const
+{
+    if (_slots.empty())
+        return nullptr;
+    size_t pos = Probe(_slots, hash, [&](uint32_t i) {
+        const Entry& entry = _entries[i];
+        const Section& stored = _sections[entry.section];
+        return EqualLower(name, Text(entry.name, entry.name_size)) &&
+               EqualLower(section, Text(stored.name, stored.name_size));
+    });
+    return _slots[pos].index ? &_entries[_slots[pos].index - 1] : nullptr;
+}
+
+const INIReader::Entry* INIReader::Find(Handle key) const
+{
+    return key._index < _entries.size() ? &_entries[key._index] : nullptr;
+}
+
+const INIReader::Section* INIReader::FindSection(string_view section) const
+{
+    if (_section_slots.empty())
+        return nullptr;
+    size_t pos = Probe(_section_slots, SectionHash(section), [&](uint32_t i) {
+        return EqualLower(section, Text(_sections[i].name, _sections[i].name_size));
+    });
+    return _section_slots[pos].index ? &_sections[_section_slots[pos].index - 1] : nullptr;
+}
+
+INIReader::MemoryStats INIReader::MemoryUsage() const
+{
+    // The source text of a kLazy reader isn't counted: it is the caller's
+    // buffer, borrowed or adopted, or the file mapping
+    size_t copied = 0;
+    size_t copied_blocks = 0;
+    if (_store)
     {
-        if (it->first.compare(0, keyPrefix.length(), keyPrefix) == 0) 
+        std::lock_guard<std::mutex> lock(_store->mutex);
+        copied = _store->bytes;
+        copied_blocks = 1 + _store->blocks.size() + (_store->blocks.capacity() > 0);
+    }
+    MemoryStats stats;
+    stats.strings = _arena.capacity() + copied;
+    stats.records = _entries.capacity() * sizeof(Entry) + _sections.capacity() * sizeof(Section) +
+                    _multi.capacity() * sizeof(MultiValue) + _pieces.capacity() * sizeof(Piece) +
+                    _lazy_values.capacity() * sizeof(LazyValue);
+    stats.index = (_slots.capacity() + _section_slots.capacity()) * sizeof(Slot) +
+                  _section_keys.capacity() * sizeof(uint32_t);
+    stats.total = stats.strings + stats.records + stats.index;
+    stats.allocations = (_arena.capacity() > 0) + (_entries.capacity() > 0) + (_sections.capacity() > 0) +
+                        (_slots.capacity() > 0) + (_section_slots.capacity() > 0) +
+                        (_section_keys.capacity() > 0) + (_multi.capacity() > 0) + (_pieces.capacity() > 0) +
+                        (_lazy_values.capacity() > 0) + copied_blocks;
+    return stats;
+}
+
+std::vector<INIReader::KeyAccess> INIReader::AccessReport() const
+{
+    std::vector<KeyAccess> report;
+#if INI_READER_STATS
+    if (!_access)
+        return report;
+    report.reserve(_entries.size());
+    for (const Entry& entry : _entries)
+    {
+        const Section& section = _sections[entry.section];
+        report.push_back(KeyAccess{string(Text(section.name, section.name_size)),
+                                   string(Text(entry.name, entry.name_size)), true, 0, 0, 0});
+    }
+    std::map<std::pair<string, string>, uint64_t> misses;
+    {
+        std::lock_guard<std::mutex> lock(_access->mutex);
+        for (const std::unique_ptr<AccessLog::Shard>& shard : _access->shards)
         {
-            keys.push_back(it->first.substr(keyPrefix.length()));
+            for (size_t i = 0; i < report.size(); i++)
+            {
+                report[i].reads += shard->Count(2 * i).load(std::memory_order_relaxed);
+                report[i].fallbacks += shard->Count(2 * i + 1).load(std::memory_order_relaxed);
+            }
+            std::lock_guard<std::mutex> shard_lock(shard->mutex);
+            for (const auto& miss : shard->misses)
+                misses[miss.first] += miss.second;
         }
     }
-    return keys;
+    for (const auto& miss : misses)
+        report.push_back(KeyAccess{miss.first.first, miss.first.second, false, 0, miss.second, 0});
+
+    std::sort(report.begin(), report.end(), [](const KeyAccess& a, const KeyAccess& b) {
+        if (a.reads + a.misses != b.reads + b.misses)
+            return a.reads + a.misses > b.reads + b.misses;
+        if (a.section != b.section)
+            return a.section < b.section;
+        return a.name < b.name;
+    });
+#endif
+    return report;
 }
 
-bool INIReader::HasSection(const string& section) const
+uint32_t INIReader::Intern(string_view text, bool lower)
 {
-    const string key = MakeKey(section, "");
-    std::map<string, string>::const_iterator pos = _values.lower_bound(key);
-    if (pos == _values.end())
-        return false;
-    // Does the key at the lower_bound pos start with "section"?
-    return pos->first.compare(0, key.length(), key) == 0;
+    uint32_t offset = static_cast<uint32_t>(_arena.size());
+    _arena.insert(_arena.end(), text.begin(), text.end());
+    if (lower)
+    {
+        for (size_t i = offset; i < _arena.size(); i++)
+            _arena[i] = LowerChar(_arena[i]);
+    }
+    _arena.push_back('\0');
+    return offset;
 }
 
-bool INIReader::HasValue(const string& section, const string& name) const
+// Build the section directory once all values are in, and give back what
+// the vectors over-allocated while growing
+void INIReader::Finish()
 {
-    string key = MakeKey(section, name);
-    return _values.count(key);
+    // Counting sort of the entries by section, keeping file order
+    for (Section& section : _sections)
+        section.key_count = 0;
+    for (const Entry& entry : _entries)
+        _sections[entry.section].key_count++;
+    uint32_t first = 0;
+    for (Section& section : _sections)
+    {
+        section.first_key = first;
+        first += section.key_count;
+        section.key_count = 0;
+    }
+    _section_keys.resize(_entries.size());
+    for (size_t i = 0; i < _entries.size(); i++)
+    {
+        Section& section = _sections[_entries[i].section];
+        _section_keys[section.first_key + section.key_count++] = static_cast<uint32_t>(i);
+    }
+
+    if (_arena.capacity() - _arena.size() > _arena.size() / 8)
+        _arena.shrink_to_fit();
+    if (_entries.capacity() - _entries.size() > _entries.size() / 8)
+        _entries.shrink_to_fit();
+    if (_lazy_values.capacity() - _lazy_values.size() > _lazy_values.size() / 8)
+        _lazy_values.shrink_to_fit();
+    if (_multi.capacity() - _multi.size() > _multi.size() / 8)
+        _multi.shrink_to_fit();
+    if (_pieces.capacity() - _pieces.size() > _pieces.size() / 8)
+        _pieces.shrink_to_fit();
+#if INI_READER_STATS
+    _access = std::make_shared<AccessLog>(_entries.size());
+#endif
 }
 
-string INIReader::MakeKey(const string& section, const string& name)
+// Join the lines of a value with "\n" the first time it is read as one
+// string. Several threads may ask at once; the first to take the lock
+// builds it and the others get its copy
+const char* INIReader::Joined(const Entry& entry) const
 {
-    string key = section + "=" + name;
-    // Convert to lower case to make section/name lookups case-insensitive
-    std::transform(key.begin(), key.end(), key.begin(),
-        [](const unsigned char& ch) { 
-            return static_cast<unsigned char>(::tolower(ch)); 
-        });
-    return key;
+    const MultiValue& multi = _multi[entry.value];
+    const char* data = multi.joined.load(std::memory_order_acquire);
+    if (data)
+        return data;
+    std::lock_guard<std::mutex> lock(_store->mutex);
+    data = multi.joined.load(std::memory_order_relaxed);
+    if (data)
+        return data;
+
+    // An empty line only adds a "\n" after text, the same as joining the
+    // lines as they were parsed would
+    char* copy = _store->Allocate(entry.value_size + 1);
+    size_t size = 0;
+    for (uint32_t i = multi.first_piece; i != 0; i = _pieces[i - 1].next)
+    {
+        const Piece& piece = _pieces[i - 1];
+        if (size > 0)
+            copy[size++] = '\n';
+        memcpy(copy + size, PieceText(piece.offset, piece.size).data(), piece.size);
+        size += piece.size;
+    }
+    copy[entry.value_size] = '\0';
+    multi.joined.store(copy, std::memory_order_release);
+    return copy;
 }
 
-int INIReader::ValueHandler(void* user, const char* section, const char* name,
-                            const char* value)
+// Copy a one-line kLazy value out of the source the first time it is read,
+// the same way
+const char* INIReader::Materialize(const Entry& entry) const
 {
-    if (!name)  // Happens when INI_CALL_HANDLER_ON_NEW_SECTION enabled
+    const LazyValue& lazy = _lazy_values[&entry - _entries.data()];
+    std::lock_guard<std::mutex> lock(_store->mutex);
+    const char* data = lazy.data.load(std::memory_order_relaxed);
+    if (data)
+        return data;
+
+    // A value already followed by a NUL, as Adopt() leaves them and as
+    // values copied to the arena are, is used where it is
+    string_view text = PieceText(entry.value, entry.value_size);
+    size_t end = static_cast<size_t>(entry.value) + entry.value_size;
+    if (entry.value_size == 0)
+    {
+        data = "";
+    }
+    else if (entry.value >= _source_size || (end < _source_size && _source[end] == '\0'))
+    {
+        data = text.data();
+    }
+    else
+    {
+        char* copy = _store->Allocate(entry.value_size + 1);
+        memcpy(copy, text.data(), entry.value_size);
+        copy[entry.value_size] = '\0';
+        data = copy;
+    }
+    lazy.data.store(data, std::memory_order_release);
+    return data;
+}
+
+// Add another line to a key's value. On the second line the value becomes a
+// MultiValue, with its first line as the first piece; nothing is joined
+// until the value is read
+void INIReader::AddPiece(Entry& stored, uint32_t offset, uint32_t size)
+{
+    if (!stored.multi)
+    {
+        _pieces.push_back(Piece{stored.value, stored.value_size, 0});
+        uint32_t first = static_cast<uint32_t>(_pieces.size());
+        _multi.push_back(MultiValue{first, first, 1, {}});
+        stored.value = static_cast<uint32_t>(_multi.size() - 1);
+        stored.multi = 1;
+        if (!_store)
+            _store = std::make_shared<ValueStore>();
+    }
+    MultiValue& multi = _multi[stored.value];
+    _pieces.push_back(Piece{offset, size, 0});
+    _pieces[multi.last_piece - 1].next = static_cast<uint32_t>(_pieces.size());
+    multi.last_piece = static_cast<uint32_t>(_pieces.size());
+    multi.count++;
+    stored.value_size += (stored.value_size > 0 ? 1 : 0) + size;
+}
+
+int INIReader::ValueHandler(void* user, const ini_entry* entry)
+{
+    if (!entry->name)  // Happens when INI_CALL_HANDLER_ON_NEW_SECTION enabled
         return 1;
 
     INIReader* reader = static_cast<INIReader*>(user);
-    string key = MakeKey(section, name);
-    if (reader->_values[key].size() > 0)
-        reader->_values[key] += "\n";
-    reader->_values[key] += value ? value : "";
-    
+    string_view section(entry->section, entry->section_len);
+    string_view name(entry->name, entry->name_len);
+    string_view value(entry->value ? entry->value : "", entry->value ? entry->value_len : 0);
+    bool lazy = reader->_lazy;
+    // Copy the value into the arena, or in kLazy mode only note where it is
+    // in the source if the parser handed it out in place (see PieceText())
+    uint32_t offset = 0;
+    bool in_source = false;
+    uint64_t base = 0;
+    if (lazy)
+    {
+        uintptr_t begin = reinterpret_cast<uintptr_t>(reader->_source);
+        uintptr_t at = reinterpret_cast<uintptr_t>(value.data());
+        in_source = value.empty() || (at >= begin && at - begin + value.size() <= reader->_source_size);
+        if (in_source)
+            offset = value.empty() ? 0 : static_cast<uint32_t>(at - begin);
+        base = reader->_source_size;
+    }
+    // Offsets are 32 bits
+    uint64_t needed = base + reader->_arena.size() + section.size() + name.size() +
+                      (in_source ? 0 : value.size()) + 3;
+    if (needed > UINT32_MAX)
+        return 0;
+    if (!in_source)
+        offset = static_cast<uint32_t>(base + reader->Intern(value, false));
+
+    // A repeated key or continuation line adds a piece to the value;
+    // nothing already stored is copied
+    Entry* stored = const_cast<Entry*>(reader->Find(section, name));
+    if (stored)
+    {
+        reader->AddPiece(*stored, offset, static_cast<uint32_t>(value.size()));
+        return 1;
+    }
+
+    // Hash straight from the entry; a key is only lower-cased and copied
+    // the first time it is seen
+    const Section* found = reader->FindSection(section);
+    if (!found)
+    {
+        uint32_t name_offset = reader->Intern(section, true);
+        reader->_sections.push_back(Section{SectionHash(section), name_offset, static_cast<uint32_t>(section.size()), 0, 0});
+        AddSlot(reader->_section_slots, reader->_sections);
+        found = &reader->_sections.back();
+    }
+    Entry added;
+    added.hash = KeyHash(section, name);
+    added.section = static_cast<uint32_t>(found - reader->_sections.data());
+    added.name = reader->Intern(name, true);
+    added.name_size = static_cast<uint32_t>(name.size());
+    added.value = offset;
+    added.value_size = static_cast<uint32_t>(value.size());
+    added.multi = 0;
+    reader->_entries.push_back(added);
+    AddSlot(reader->_slots, reader->_entries);
+    if (lazy)
+        reader->_lazy_values.emplace_back();
     return 1;
 }
@@ -0,0 +1,224 @@
+// Text helpers shared by INIReader and INICache: ASCII case folding, key
+// hashing and the typed value parsers, so that both classes fold, hash and
+// convert values the same way. Private to the library; not installed.
+
+// SPDX-License-Identifier: BSD-3-Clause
+
+// inih and INIReader are released under the New BSD license (see LICENSE.txt).
+// Go to the project home page for more info:
+//
+// https://github.com/benhoyt/inih
+
+#ifndef INITEXT_H
+#define INITEXT_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+namespace ini_text
+{
+
+// Lower-case eight ASCII bytes at once. Bytes >= 0x80 are left alone, the
+// same as ::tolower() in the C locale
+inline uint64_t LowerWord(uint64_t w)
+{
+    uint64_t heptets = w & 0x7f7f7f7f7f7f7f7fULL;
+    uint64_t above_a = heptets + 0x3f3f3f3f3f3f3f3fULL;  // High bit set if >= 'A'
+    uint64_t above_z = heptets + 0x2525252525252525ULL;  // High bit set if > 'Z'
+    uint64_t upper = (above_a ^ above_z) & ~w & 0x8080808080808080ULL;
+    return w | (upper >> 2);
+}
+
+inline char LowerChar(char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch + ('a' - 'A')) : ch;
+}
+
+inline uint64_t Mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// Case-insensitive hash, eight bytes at a time, so that a query hashes the
+// same as the lower-cased stored string without being lower-cased first
+inline uint64_t HashLower(std::string_view s, uint64_t h)
+{
+    const char* p = s.data();
+    size_t n = s.size();
+
+    h ^= n * 0x9e3779b97f4a7c15ULL;
+    for (; n >= 8; p += 8, n -= 8)
+    {
+        uint64_t w;
+        memcpy(&w, p, 8);
+        h = (h ^ LowerWord(w)) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    if (n > 0)
+    {
+        uint64_t w = 0;
+        memcpy(&w, p, n);
+        h = (h ^ LowerWord(w)) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+inline uint64_t SectionHash(std::string_view section)
+{
+    return Mix(HashLower(section, 0));
+}
+
+// Hash of a (section, name) key. INICache varies seed until its perfect
+// hash builds; INIReader always uses 0
+inline uint64_t KeyHash(std::string_view section, std::string_view name, uint64_t seed = 0)
+{
+    return Mix(HashLower(name, HashLower(section, seed)));
+}
+
+// Compare a query case-insensitively against a lower-cased stored string
+inline bool EqualLower(std::string_view query, std::string_view stored)
+{
+    size_t n = query.size();
+    if (n != stored.size())
+        return false;
+    const char* a = query.data();
+    const char* b = stored.data();
+    for (; n >= 8; a += 8, b += 8, n -= 8)
+    {
+        uint64_t wa, wb;
+        memcpy(&wa, a, 8);
+        memcpy(&wb, b, 8);
+        if (LowerWord(wa) != wb)
+            return false;
+    }
+    for (; n > 0; a++, b++, n--)
+    {
+        if (LowerChar(*a) != *b)
+            return false;
+    }
+    return true;
+}
+
+inline bool IsSpace(char ch)
+{
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+inline bool IsHexDigit(char ch)
+{
+    return (ch >= '0' && ch <= '9') || ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'f');
+}
+
+// Parse an integer with the same syntax and results as strtol/strtoul
+// with base 0: leading whitespace, an optional sign, "0x" for hex and a
+// leading "0" for octal, clamping on overflow (a minus sign negates
+// unsigned values modulo 2^N), and anything after the digits ignored. It
+// goes through std::from_chars, so it is locale-independent and doesn't
+// touch errno. Return false if there are no digits
+template <class T>
+bool ParseInteger(std::string_view s, T* out)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    const char* p = s.data();
+    const char* end = p + s.size();
+
+    while (p < end && IsSpace(*p))
+        p++;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-'))
+        negative = *p++ == '-';
+    int base = 10;
+    if (p < end && *p == '0')
+    {
+        base = 8;
+        if (end - p > 2 && (p[1] == 'x' || p[1] == 'X') && IsHexDigit(p[2]))
+        {
+            base = 16;
+            p += 2;
+        }
+    }
+
+    uint64_t magnitude = 0;
+    std::from_chars_result result = std::from_chars(p, end, magnitude, base);
+    if (result.ec == std::errc::invalid_argument)
+        return false;
+    bool overflow = result.ec == std::errc::result_out_of_range;
+
+    if (std::is_signed<T>::value)
+    {
+        U limit = static_cast<U>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+        if (overflow || magnitude > limit)
+            *out = negative ? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+        else
+            *out = static_cast<T>(negative ? U(0) - static_cast<U>(magnitude) : static_cast<U>(magnitude));
+    }
+    else
+    {
+        if (overflow || magnitude > std::numeric_limits<U>::max())
+            *out = std::numeric_limits<T>::max();
+        else
+            *out = static_cast<T>(negative ? U(0) - static_cast<U>(magnitude) : static_cast<U>(magnitude));
+    }
+    return true;
+}
+
+// Parse a floating point value with the same results as strtod in the C
+// locale. Decimal values go through std::from_chars (an Eisel-Lemire
+// implementation in current standard libraries); hex floats and values
+// outside double's range are rare and fall back to strtod, which s must
+// be NUL-terminated for
+inline bool ParseReal(std::string_view s, double* out)
+{
+#if defined(__cpp_lib_to_chars)
+    const char* p = s.data();
+    const char* end = p + s.size();
+
+    while (p < end && IsSpace(*p))
+        p++;
+    if (p < end && *p == '+')
+    {
+        p++;
+        if (p < end && *p == '-')  // from_chars would take "+-1" as -1
+            return false;
+    }
+    const char* digits = p < end && *p == '-' ? p + 1 : p;
+    if (!(end - digits > 1 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')))
+    {
+        std::from_chars_result result = std::from_chars(p, end, *out);
+        if (result.ec == std::errc())
+            return true;
+        if (result.ec == std::errc::invalid_argument)
+            return false;
+    }
+#endif
+    char* end_ptr;
+    *out = strtod(s.data(), &end_ptr);
+    return end_ptr > s.data();
+}
+
+// Parse "true", "yes", "on", "1" as true and "false", "no", "off", "0" as
+// false, in any case. Return false for anything else
+inline bool ParseBoolean(std::string_view s, bool* out)
+{
+    *out = false;
+    if (EqualLower(s, "true") || EqualLower(s, "yes") || EqualLower(s, "on") || EqualLower(s, "1"))
+        *out = true;
+    else if (!(EqualLower(s, "false") || EqualLower(s, "no") || EqualLower(s, "off") || EqualLower(s, "0")))
+        return false;
+    return true;
+}
+
+}  // namespace ini_text
+
+#endif  // INITEXT_H
@@ -22,7 +22,6 @@
 
 #include "ini.h"
 
-#if !INI_USE_STACK
 #if INI_CUSTOM_ALLOCATOR
 #include <stddef.h>
 void* ini_malloc(size_t size);
@@ -34,49 +33,71 @@ void* ini_realloc(void* ptr, size_t size);
 #define ini_free free
 #define ini_realloc realloc
 #endif
+
+#if INI_USE_SIMD
+#include <immintrin.h>
 #endif
 
-#define MAX_SECTION 50
-#define MAX_NAME 50
+#if INI_USE_MMAP
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
-// 用于跟踪字符串解析状态
-typedef struct 
-{
-    const char* ptr;
-    size_t num_left;
-} ini_parse_string_ctx;
+#if INI_USE_THREADS
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+#endif
+
+// ini_parse_parallel每个分块的目标大小，实际分块在其后第一个[section]行处切开
+#ifndef INI_PARALLEL_CHUNK
+#define INI_PARALLEL_CHUNK (1 << 20)
+#endif
 
-// 将空白字符从给定字符串的末尾删除，then Return s. 
-static char* ini_rstrip(char* s)
+// ini_parse_file每次fread的块大小
+#ifndef INI_BLOCK_SIZE
+#define INI_BLOCK_SIZE 65536
+#endif
+
+// C locale下的空白字符（' '、'\t'、'\n'、'\v'、'\f'、'\r'）。不使用isspace，
+// 解析结果不受setlocale影响，也保证标量与SIMD实现逐字节一致
+#define ini_isspace(c) ((c) == ' ' || (unsigned char)((c) - '\t') <= '\r' - '\t')
+
+// 字符c是否属于字符集合set（NUL字节不属于任何集合）
+#define ini_in_set(set, c) ((c) != '\0' && strchr(set, c) != NULL)
+
+// 返回[s, end)中末尾空白字符之前的位置（即strip后的新end），不修改字符串
+static char* ini_rstrip(char* s, char* end)
 {
-    char* p = s + strlen(s);
-    while (p > s && isspace((unsigned char)(*--p)))
-        *p = '\0';
-    return s;
+    while (end > s && ini_isspace(*(end - 1)))
+        end -- ;
+    return end;
 }
 
-// 返回指向给定字符串中第一个非空格字符的指针
-static char* ini_lskip(const char* s)
+// 返回指向[s, end)中第一个非空格字符的指针，找不到时返回end
+static char* ini_lskip(const char* s, const char* end)
 {
-    while (*s && isspace((unsigned char)(*s)))
+    while (s < end && ini_isspace(*s))
         s ++ ;
     return (char*)s;
 }
 
-// 返回指向给定字符串中第一个字符（或多个字符）或内联注释的指针，
-// 或者，如果两者都找不到，则指向字符串末尾的NUL。内联注释必须
-// 前缀为空白字符以注册为注释
-static char* ini_find_chars_or_comment(const char* s, const char* chars)
+// ini_find_chars_or_comment的标量实现，was_space为s前一个字节是否为空白
+static char* ini_find_chars_or_comment_from(const char* s, const char* end, const char* chars,
+                                            int was_space)
 {
 #if INI_ALLOW_INLINE_COMMENTS
-    int was_space = 0;
-    while (*s && (!chars || !strchr(chars, *s)) && !(was_space && strchr(INI_INLINE_COMMENT_PREFIXES, *s))) 
+    while (s < end && (!chars || !ini_in_set(chars, *s)) && !(was_space && ini_in_set(INI_INLINE_COMMENT_PREFIXES, *s))) 
     {
-        was_space = isspace((unsigned char)(*s));
+        was_space = ini_isspace(*s);
         s++;
     }
 #else
-    while (*s && (!chars || !strchr(chars, *s))) 
+    (void)was_space;
+    while (s < end && (!chars || !ini_in_set(chars, *s))) 
     {
         s ++ ;
     }
@@ -84,20 +105,968 @@ static char* ini_find_chars_or_comment(const char* s, const char* chars)
     return (char*)s;
 }
 
-// 类似于strncpy，但确保dest（大小字节）为NUL终止，并且不使用NUL填充
-static char* ini_strncpy0(char* dest, const char* src, size_t size)
+// 返回指向[s, end)中第一个字符（或多个字符）或内联注释的指针，
+// 或者，如果两者都找不到，则返回end。内联注释必须
+// 前缀为空白字符以注册为注释
+static char* ini_find_chars_or_comment(const char* s, const char* end, const char* chars)
+{
+    return ini_find_chars_or_comment_from(s, end, chars, 0);
+}
+
+#if INI_USE_SIMD
+// 以下SIMD实现一次对16/32字节分类（空白、chars中的分隔符、内联注释前缀），
+// 不足一整块的尾部交给标量实现，结果与标量版本逐字节一致。
+// 集合超过INI_SCAN_MAX_SET个字符时直接使用标量实现
+#define INI_SCAN_MAX_SET 8
+
+__attribute__((target("sse2")))
+static __m128i ini_isspace_sse2(__m128i x)
+{
+    // '\t'..'\r'是连续区间：x - '\t'按无符号比较 <= 4
+    __m128i t = _mm_sub_epi8(x, _mm_set1_epi8('\t'));
+    __m128i range = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8('\r' - '\t')), t);
+    return _mm_or_si128(range, _mm_cmpeq_epi8(x, _mm_set1_epi8(' ')));
+}
+
+__attribute__((target("sse2")))
+static char* ini_lskip_sse2(const char* s, const char* end)
+{
+    unsigned mask;
+
+    while (end - s >= 16)
+    {
+        mask = ~(unsigned)_mm_movemask_epi8(ini_isspace_sse2(_mm_loadu_si128((const __m128i*)s))) & 0xFFFFu;
+        if (mask)
+            return (char*)s + __builtin_ctz(mask);
+        s += 16;
+    }
+    return ini_lskip(s, end);
+}
+
+__attribute__((target("sse2")))
+static char* ini_rstrip_sse2(char* s, char* end)
+{
+    unsigned mask;
+
+    while (end - s >= 16)
+    {
+        mask = ~(unsigned)_mm_movemask_epi8(ini_isspace_sse2(_mm_loadu_si128((const __m128i*)(end - 16)))) & 0xFFFFu;
+        if (mask)
+            return end - 16 + (32 - __builtin_clz(mask));
+        end -= 16;
+    }
+    return ini_rstrip(s, end);
+}
+
+__attribute__((target("sse2")))
+static char* ini_find_chars_or_comment_sse2(const char* s, const char* end, const char* chars)
 {
-    /* Could use strncpy internally, but it causes gcc warnings (see issue #91) */
+    __m128i chars_v[INI_SCAN_MAX_SET];
+    size_t nchars = chars ? strlen(chars) : 0;
     size_t i;
-    for (i = 0; i < size - 1 && src[i]; i++)
-        dest[i] = src[i];
-    dest[i] = '\0';
+#if INI_ALLOW_INLINE_COMMENTS
+    __m128i prefix_v[INI_SCAN_MAX_SET];
+    size_t nprefix = sizeof(INI_INLINE_COMMENT_PREFIXES) - 1;
+    unsigned space_mask;
+    unsigned comment_mask;
+#endif
+    unsigned carry = 0;  // 上一块最后一个字节是否为空白
+    unsigned mask;
+    __m128i x;
+    __m128i hit;
+
+#if INI_ALLOW_INLINE_COMMENTS
+    if (nchars > INI_SCAN_MAX_SET || nprefix > INI_SCAN_MAX_SET)
+        return ini_find_chars_or_comment(s, end, chars);
+    for (i = 0; i < nprefix; i++)
+        prefix_v[i] = _mm_set1_epi8(INI_INLINE_COMMENT_PREFIXES[i]);
+#else
+    if (nchars > INI_SCAN_MAX_SET)
+        return ini_find_chars_or_comment(s, end, chars);
+#endif
+    for (i = 0; i < nchars; i++)
+        chars_v[i] = _mm_set1_epi8(chars[i]);
+
+    while (end - s >= 16)
+    {
+        x = _mm_loadu_si128((const __m128i*)s);
+        hit = _mm_setzero_si128();
+        for (i = 0; i < nchars; i++)
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(x, chars_v[i]));
+        mask = (unsigned)_mm_movemask_epi8(hit);
+#if INI_ALLOW_INLINE_COMMENTS
+        hit = _mm_setzero_si128();
+        for (i = 0; i < nprefix; i++)
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(x, prefix_v[i]));
+        comment_mask = (unsigned)_mm_movemask_epi8(hit);
+        space_mask = (unsigned)_mm_movemask_epi8(ini_isspace_sse2(x));
+        // 注释前缀只有紧跟在空白之后才算注释
+        mask |= comment_mask & ((space_mask << 1) | carry);
+        carry = (space_mask >> 15) & 1u;
+#endif
+        if (mask)
+            return (char*)s + __builtin_ctz(mask);
+        s += 16;
+    }
+    return ini_find_chars_or_comment_from(s, end, chars, (int)carry);
+}
+
+__attribute__((target("avx2")))
+static __m256i ini_isspace_avx2(__m256i x)
+{
+    __m256i t = _mm256_sub_epi8(x, _mm256_set1_epi8('\t'));
+    __m256i range = _mm256_cmpeq_epi8(_mm256_min_epu8(t, _mm256_set1_epi8('\r' - '\t')), t);
+    return _mm256_or_si256(range, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')));
+}
+
+__attribute__((target("avx2")))
+static char* ini_lskip_avx2(const char* s, const char* end)
+{
+    unsigned mask;
+
+    while (end - s >= 32)
+    {
+        mask = ~(unsigned)_mm256_movemask_epi8(ini_isspace_avx2(_mm256_loadu_si256((const __m256i*)s)));
+        if (mask)
+            return (char*)s + __builtin_ctz(mask);
+        s += 32;
+    }
+    return ini_lskip_sse2(s, end);
+}
+
+__attribute__((target("avx2")))
+static char* ini_rstrip_avx2(char* s, char* end)
+{
+    unsigned mask;
+
+    while (end - s >= 32)
+    {
+        mask = ~(unsigned)_mm256_movemask_epi8(ini_isspace_avx2(_mm256_loadu_si256((const __m256i*)(end - 32))));
+        if (mask)
+            return end - 32 + (32 - __builtin_clz(mask));
+        end -= 32;
+    }
+    return ini_rstrip_sse2(s, end);
+}
+
+__attribute__((target("avx2")))
+static char* ini_find_chars_or_comment_avx2(const char* s, const char* end, const char* chars)
+{
+    __m256i chars_v[INI_SCAN_MAX_SET];
+    size_t nchars = chars ? strlen(chars) : 0;
+    size_t i;
+#if INI_ALLOW_INLINE_COMMENTS
+    __m256i prefix_v[INI_SCAN_MAX_SET];
+    size_t nprefix = sizeof(INI_INLINE_COMMENT_PREFIXES) - 1;
+    unsigned space_mask;
+    unsigned comment_mask;
+#endif
+    unsigned carry = 0;  // 上一块最后一个字节是否为空白
+    unsigned mask;
+    __m256i x;
+    __m256i hit;
+
+#if INI_ALLOW_INLINE_COMMENTS
+    if (nchars > INI_SCAN_MAX_SET || nprefix > INI_SCAN_MAX_SET)
+        return ini_find_chars_or_comment(s, end, chars);
+    for (i = 0; i < nprefix; i++)
+        prefix_v[i] = _mm256_set1_epi8(INI_INLINE_COMMENT_PREFIXES[i]);
+#else
+    if (nchars > INI_SCAN_MAX_SET)
+        return ini_find_chars_or_comment(s, end, chars);
+#endif
+    for (i = 0; i < nchars; i++)
+        chars_v[i] = _mm256_set1_epi8(chars[i]);
+
+    while (end - s >= 32)
+    {
+        x = _mm256_loadu_si256((const __m256i*)s);
+        hit = _mm256_setzero_si256();
+        for (i = 0; i < nchars; i++)
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(x, chars_v[i]));
+        mask = (unsigned)_mm256_movemask_epi8(hit);
+#if INI_ALLOW_INLINE_COMMENTS
+        hit = _mm256_setzero_si256();
+        for (i = 0; i < nprefix; i++)
+            hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(x, prefix_v[i]));
+        comment_mask = (unsigned)_mm256_movemask_epi8(hit);
+        space_mask = (unsigned)_mm256_movemask_epi8(ini_isspace_avx2(x));
+        // 注释前缀只有紧跟在空白之后才算注释
+        mask |= comment_mask & ((space_mask << 1) | carry);
+        carry = space_mask >> 31;
+#endif
+        if (mask)
+            return (char*)s + __builtin_ctz(mask);
+        s += 32;
+    }
+    return ini_find_chars_or_comment_from(s, end, chars, (int)carry);
+}
+#endif /* INI_USE_SIMD */
+
+// 一组字符分类函数，解析开始时按ini_simd_level()选定
+typedef struct ini_scanner
+{
+    char* (*lskip)(const char* s, const char* end);
+    char* (*rstrip)(char* s, char* end);
+    char* (*find_chars_or_comment)(const char* s, const char* end, const char* chars);
+} ini_scanner;
+
+static const ini_scanner ini_scanners[] =
+{
+    { ini_lskip, ini_rstrip, ini_find_chars_or_comment },
+#if INI_USE_SIMD
+    { ini_lskip_sse2, ini_rstrip_sse2, ini_find_chars_or_comment_sse2 },
+    { ini_lskip_avx2, ini_rstrip_avx2, ini_find_chars_or_comment_avx2 },
+#endif
+};
+
+#if INI_USE_SIMD
+static int ini_simd_level_value = -1;  // -1表示尚未检测CPU
+#endif
+
+// 当前CPU支持的最高级别
+static int ini_simd_level_max(void)
+{
+#if INI_USE_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return INI_SIMD_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return INI_SIMD_SSE2;
+#endif
+    return INI_SIMD_SCALAR;
+}
+
+int ini_simd_level(void)
+{
+#if INI_USE_SIMD
+    int level = __atomic_load_n(&ini_simd_level_value, __ATOMIC_RELAXED);
+    if (level < 0)
+    {
+        level = ini_simd_level_max();
+        __atomic_store_n(&ini_simd_level_value, level, __ATOMIC_RELAXED);
+    }
+    return level;
+#else
+    return INI_SIMD_SCALAR;
+#endif
+}
+
+int ini_set_simd_level(int level)
+{
+    int max = ini_simd_level_max();
+
+    if (level < INI_SIMD_SCALAR || level > max)
+        level = max;
+#if INI_USE_SIMD
+    __atomic_store_n(&ini_simd_level_value, level, __ATOMIC_RELAXED);
+#endif
+    return level;
+}
+
+// 将[src, src + len)拷贝到dest（size字节），超长部分截断，并确保dest以NUL结尾
+static char* ini_strncpy0(char* dest, const char* src, size_t len, size_t size)
+{
+    if (len > size - 1)
+        len = size - 1;
+    memcpy(dest, src, len);
+    dest[len] = '\0';
     return dest;
 }
 
+static void ini_state_init(ini_parse_state* st, ini_handler handler, ini_handler_ex handler_ex,
+                           void* user)
+{
+    st->handler = handler;
+    st->handler_ex = handler_ex;
+    st->user = user;
+    st->scan = &ini_scanners[ini_simd_level()];
+    st->section_buf[0] = '\0';
+    st->section = st->section_buf;
+    st->section_len = 0;
+#if INI_ALLOW_MULTILINE
+    st->prev_name_buf[0] = '\0';
+    st->prev_name = st->prev_name_buf;
+    st->prev_name_len = 0;
+#endif
+    st->in_place = 0;
+    st->terminate = handler_ex == NULL;
+    st->lineno = 0;
+    st->offset = 0;
+    st->error = 0;
+}
 
-int ini_parse_stream(ini_reader reader, void* stream, ini_handler handler,
-                     void* user)
+// 记录新的节名或键名：就地模式下直接引用行内存，否则（或超长需截断时）拷贝到buf
+static const char* ini_state_keep(ini_parse_state* st, char* s, size_t len, size_t* out_len,
+                                  char* buf, size_t size)
+{
+    if (len > size - 1)
+        len = size - 1;
+    *out_len = len;
+    // 调用者已在名称末尾写入NUL；s[len]不是NUL说明名称超长被截断，只能拷贝
+    if (!st->in_place || (st->terminate && s[len] != '\0'))
+        return ini_strncpy0(buf, s, len, size);
+    return s;
+}
+
+// 把一个条目交给handler：ini_handler要求name/value已由调用者写好NUL结束符
+static int ini_call_handler(ini_parse_state* st, const char* name, size_t name_len,
+                            const char* value, size_t value_len)
+{
+    ini_entry entry;
+
+    if (st->handler_ex)
+    {
+        entry.section = st->section;
+        entry.section_len = st->section_len;
+        entry.name = name;
+        entry.name_len = name_len;
+        entry.value = value;
+        entry.value_len = value_len;
+        entry.lineno = st->lineno;
+        entry.offset = st->offset;
+        return st->handler_ex(st->user, &entry);
+    }
+    // 回调函数原型
+#if INI_HANDLER_LINENO
+    return st->handler(st->user, st->section, name, value, st->lineno);
+#else
+    return st->handler(st->user, st->section, name, value);
+#endif
+}
+
+// 解析一行[line, line + len)，行号和偏移由调用者维护。
+// 使用ini_handler时line[len]必须可写：name和value会被就地写入NUL结束符后传给handler
+static void ini_parse_line(ini_parse_state* st, char* line, size_t len)
+{
+    char* start = line;
+    char* line_end = line + len;
+    char* end;
+    char* name;
+    char* name_end;
+    char* value;
+    char* value_end;
+
+#if INI_ALLOW_BOM
+    if (st->lineno == 1 && len >= 3 &&
+                           (unsigned char)start[0] == 0xEF &&
+                           (unsigned char)start[1] == 0xBB &&
+                           (unsigned char)start[2] == 0xBF)
+    {
+        start += 3;
+    }
+#endif
+    start = st->scan->lskip(start, line_end);
+    line_end = st->scan->rstrip(start, line_end);
+
+    if (start == line_end || strchr(INI_START_COMMENT_PREFIXES, *start)) 
+    {
+        // 空行或行首注释
+    }
+
+#if INI_ALLOW_MULTILINE
+    else if (st->prev_name_len && start > line) 
+    {
+        // 若上一行解析的键为prev_name且当前行以空白开头，则将当前行内容追加到上一行的值。
+        // 如果start指针与原line指针不同，则说明行首存在空白字符
+#if INI_ALLOW_INLINE_COMMENTS
+        end = st->scan->find_chars_or_comment(start, line_end, NULL);
+        line_end = st->scan->rstrip(start, end);
+#endif
+        if (st->terminate)
+            *line_end = '\0';
+        // 带有前导空格的非空行，视为续行
+        if (!ini_call_handler(st, st->prev_name, st->prev_name_len,
+                              start, (size_t)(line_end - start)) && !st->error)
+            st->error = st->lineno;
+    }
+#endif
+    else if (*start == '[') 
+    {
+        // 找到新的一section
+        end = st->scan->find_chars_or_comment(start + 1, line_end, "]");
+        if (end < line_end && *end == ']') 
+        {
+            if (st->terminate)
+                *end = '\0';
+            st->section = ini_state_keep(st, start + 1, (size_t)(end - (start + 1)),
+                                         &st->section_len, st->section_buf, sizeof(st->section_buf));
+#if INI_ALLOW_MULTILINE
+            st->prev_name = st->prev_name_buf;
+            st->prev_name_buf[0] = '\0';
+            st->prev_name_len = 0;
+#endif
+#if INI_CALL_HANDLER_ON_NEW_SECTION
+            if (!ini_call_handler(st, NULL, 0, NULL, 0) && !st->error)
+                st->error = st->lineno;
+#endif
+        }
+        else if (!st->error) 
+        {
+            // 这个新的section没有以]结尾
+            st->error = st->lineno;
+        }
+    }
+    else 
+    {
+        // 不是注释的话，必须是name=value或者name:value
+        end = st->scan->find_chars_or_comment(start, line_end, "=:");
+        if (end < line_end && (*end == '=' || *end == ':')) 
+        {
+            name = start;
+            name_end = st->scan->rstrip(name, end);
+            if (st->terminate)
+                *name_end = '\0';
+            value = end + 1;
+#if INI_ALLOW_INLINE_COMMENTS
+            value_end = st->scan->find_chars_or_comment(value, line_end, NULL);
+#else
+            value_end = line_end;
+#endif
+            value = st->scan->lskip(value, value_end);
+            value_end = st->scan->rstrip(value, value_end);
+            if (st->terminate)
+                *value_end = '\0';
+
+#if INI_ALLOW_MULTILINE
+            st->prev_name = ini_state_keep(st, name, (size_t)(name_end - name),
+                                           &st->prev_name_len, st->prev_name_buf,
+                                           sizeof(st->prev_name_buf));
+#endif
+            // 调用回调
+            if (!ini_call_handler(st, name, (size_t)(name_end - name),
+                                  value, (size_t)(value_end - value)) && !st->error)
+                st->error = st->lineno;
+        }
+        else 
+        {
+            /// 没有找到=或者:
+            // 是否允许无值键，不允许则视为错误
+#if INI_ALLOW_NO_VALUE
+            name = start;
+            name_end = st->scan->rstrip(name, end);
+            if (st->terminate)
+                *name_end = '\0';
+            if (!ini_call_handler(st, name, (size_t)(name_end - name), NULL, 0) && !st->error)
+                st->error = st->lineno;
+#else
+            if (!st->error)
+                st->error = st->lineno;
+#endif
+        }
+    }
+}
+
+// 分块解析：处理一个完整的行。avail为该行包括换行符在内的总字节数，
+// 只有[line, line + len)被保存了下来。writable为0时line不可写入，
+// 使用ini_handler时先拷贝到partial中再解析
+static void ini_feed_line(ini_parser* fs, char* line, size_t len, size_t avail,
+                          size_t offset, int writable)
+{
+    ini_parse_state* st = &fs->st;
+
+    st->lineno ++ ;
+    st->offset = offset;
+
+    // 如果行超过INI_MAX_line字节，则丢弃，直到行结束
+    if (avail > INI_MAX_LINE - 1)
+    {
+        if (len > INI_MAX_LINE - 1)
+            len = INI_MAX_LINE - 1;
+        if (!st->error)
+            st->error = st->lineno;
+    }
+
+    if (!writable && st->terminate)
+    {
+        memcpy(fs->partial, line, len);
+        line = fs->partial;
+    }
+    ini_parse_line(st, line, len);
+}
+
+static void ini_feed_init(ini_parser* fs)
+{
+    fs->partial_len = 0;
+    fs->partial_total = 0;
+    fs->partial_offset = 0;
+    fs->has_partial = 0;
+    fs->consumed = 0;
+}
+
+// 喂入[data, data + n)。返回非0表示应停止解析（INI_STOP_ON_FIRST_ERROR）
+static int ini_feed(ini_parser* fs, char* data, size_t n, int writable)
+{
+    char* p = data;
+    char* end = data + n;
+    char* nl;
+    size_t take;
+    size_t keep;
+
+    if (fs->has_partial)
+    {
+        // 先补全上一块遗留的行
+        nl = (char*)memchr(p, '\n', n);
+        take = nl ? (size_t)(nl - p) : n;
+        keep = INI_MAX_LINE - 1 - fs->partial_len;
+        if (keep > take)
+            keep = take;
+        memcpy(fs->partial + fs->partial_len, p, keep);
+        fs->partial_len += keep;
+        fs->partial_total += nl ? take + 1 : take;
+        if (!nl)
+        {
+            fs->consumed += n;
+            return 0;
+        }
+        fs->has_partial = 0;
+        ini_feed_line(fs, fs->partial, fs->partial_len, fs->partial_total, fs->partial_offset, 1);
+        p = nl + 1;
+#if INI_STOP_ON_FIRST_ERROR
+        if (fs->st.error)
+            return 1;
+#endif
+    }
+
+    while (p < end)
+    {
+        nl = (char*)memchr(p, '\n', (size_t)(end - p));
+        if (!nl)
+        {
+            // 不完整的行，等下一块
+            fs->has_partial = 1;
+            fs->partial_offset = fs->consumed + (size_t)(p - data);
+            fs->partial_total = (size_t)(end - p);
+            fs->partial_len = fs->partial_total < INI_MAX_LINE - 1 ? fs->partial_total : INI_MAX_LINE - 1;
+            memcpy(fs->partial, p, fs->partial_len);
+            break;
+        }
+        ini_feed_line(fs, p, (size_t)(nl - p), (size_t)(nl - p) + 1,
+                      fs->consumed + (size_t)(p - data), writable);
+        p = nl + 1;
+#if INI_STOP_ON_FIRST_ERROR
+        if (fs->st.error)
+            return 1;
+#endif
+    }
+
+    fs->consumed += n;
+    return 0;
+}
+
+// 输入结束：解析最后一个没有换行符的行
+static int ini_feed_finish(ini_parser* fs)
+{
+    if (fs->has_partial)
+    {
+        fs->has_partial = 0;
+        ini_feed_line(fs, fs->partial, fs->partial_len, fs->partial_total, fs->partial_offset, 1);
+    }
+    return fs->st.error;
+}
+
+// 解析整个内存缓冲区[buf, buf + length)：用memchr切分行，不经过行缓冲区。
+// writable为1时，使用ini_handler也可以就地写入NUL结束符，只有最后一个没有换行符的行
+// 需要拷贝；writable为0时，ini_handler_ex不做任何拷贝，ini_handler每行拷贝一次
+static int ini_parse_buffer(ini_parser* fs, char* buf, size_t length, int writable)
+{
+    // 缓冲区在整个解析期间有效，节名/键名可以直接引用；但拷贝到partial中的行会被覆盖
+    fs->st.in_place = writable || !fs->st.terminate;
+    ini_feed_init(fs);
+    if (ini_feed(fs, buf, length, writable))
+        return fs->st.error;
+    return ini_feed_finish(fs);
+}
+
+// 整个缓冲区可写时（writable）才能让ini_handler就地写入NUL结束符
+static int ini_parse_whole_buffer(ini_handler handler, ini_handler_ex handler_ex, void* user,
+                                  char* buf, size_t length, int writable)
+{
+    ini_parser fs;
+
+    ini_state_init(&fs.st, handler, handler_ex, user);
+    return ini_parse_buffer(&fs, buf, length, writable);
+}
+
+#if INI_USE_THREADS
+// ini_parse_parallel：工作线程解析出的一个条目，行号和偏移相对于所在分块
+typedef struct
+{
+    const char* section;
+    size_t section_len;
+    const char* name;
+    size_t name_len;
+    const char* value;
+    size_t value_len;
+    int lineno;
+    size_t offset;
+} ini_record;
+
+// 分块私有的字符串池，用于保存指向解析状态内部缓冲区（截断的节名/键名、
+// 最后一行）的字符串。内存块只追加不移动，已记录的指针在回放前一直有效
+typedef struct ini_pool_block
+{
+    struct ini_pool_block* next;
+    size_t used;
+    size_t size;
+    char data[];
+} ini_pool_block;
+
+// 一个分块：从行首的[section]开始，到下一个分块之前结束
+typedef struct
+{
+    char* begin;
+    size_t length;
+    ini_parser fs;
+    ini_record* records;
+    size_t count;
+    size_t capacity;
+    ini_pool_block* pool;
+    int oom;
+    int done;
+} ini_chunk;
+
+typedef struct
+{
+    ini_chunk* chunks;
+    size_t nchunks;
+    int writable;
+    int terminate;
+    size_t next;      // 下一个待解析的分块
+    size_t replayed;  // 已回放给handler的分块数
+    size_t window;    // 最多领先回放多少个分块，限制暂存记录占用的内存
+    int stop;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} ini_parallel;
+
+static const char* ini_chunk_keep(ini_chunk* c, const char* s, size_t len)
+{
+    uintptr_t p = (uintptr_t)s;
+    ini_pool_block* block;
+    char* copy;
+
+    // 指向缓冲区本身的字符串在回放时依然有效，无需拷贝
+    if (!s || p < (uintptr_t)&c->fs || p >= (uintptr_t)(&c->fs + 1))
+        return s;
+
+    block = c->pool;
+    if (!block || block->size - block->used < len + 1)
+    {
+        size_t size = len + 1 > 4096 ? len + 1 : 4096;
+        block = (ini_pool_block*)ini_malloc(sizeof(ini_pool_block) + size);
+        if (!block)
+            return NULL;
+        block->next = c->pool;
+        block->used = 0;
+        block->size = size;
+        c->pool = block;
+    }
+    copy = block->data + block->used;
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    block->used += len + 1;
+    return copy;
+}
+
+// 工作线程中使用的ini_handler_ex：只把条目暂存起来，回放时再交给用户的handler
+static int ini_chunk_record(void* user, const ini_entry* entry)
+{
+    ini_chunk* c = (ini_chunk*)user;
+    ini_record* r;
+
+    if (c->count == c->capacity)
+    {
+        size_t capacity = c->capacity ? c->capacity * 2 : 256;
+        r = (ini_record*)ini_realloc(c->records, capacity * sizeof(ini_record));
+        if (!r)
+        {
+            c->oom = 1;
+            return 0;
+        }
+        c->records = r;
+        c->capacity = capacity;
+    }
+    r = &c->records[c->count];
+    r->section = ini_chunk_keep(c, entry->section, entry->section_len);
+    r->section_len = entry->section_len;
+    r->name = ini_chunk_keep(c, entry->name, entry->name_len);
+    r->name_len = entry->name_len;
+    r->value = ini_chunk_keep(c, entry->value, entry->value_len);
+    r->value_len = entry->value_len;
+    r->lineno = entry->lineno;
+    r->offset = entry->offset;
+    if (!r->section || (entry->name && !r->name) || (entry->value && !r->value))
+    {
+        c->oom = 1;
+        return 0;
+    }
+    c->count ++ ;
+    return 1;
+}
+
+static void ini_chunk_release(ini_chunk* c)
+{
+    ini_pool_block* block;
+
+    while ((block = c->pool) != NULL)
+    {
+        c->pool = block->next;
+        ini_free(block);
+    }
+    ini_free(c->records);
+    c->records = NULL;
+    c->count = c->capacity = 0;
+}
+
+static void ini_chunk_parse(ini_parallel* par, ini_chunk* c)
+{
+    ini_state_init(&c->fs.st, NULL, ini_chunk_record, c);
+    // 记录器本身按长度读取，但回放给ini_handler时需要NUL结束符
+    c->fs.st.terminate = par->terminate;
+    ini_parse_buffer(&c->fs, c->begin, c->length, par->writable);
+}
+
+static void* ini_parallel_worker(void* arg)
+{
+    ini_parallel* par = (ini_parallel*)arg;
+    ini_chunk* c;
+
+    pthread_mutex_lock(&par->lock);
+    for (;;)
+    {
+        while (!par->stop && par->next < par->nchunks && par->next >= par->replayed + par->window)
+            pthread_cond_wait(&par->cond, &par->lock);
+        if (par->stop || par->next >= par->nchunks)
+            break;
+        c = &par->chunks[par->next ++ ];
+        pthread_mutex_unlock(&par->lock);
+
+        ini_chunk_parse(par, c);
+
+        pthread_mutex_lock(&par->lock);
+        c->done = 1;
+        pthread_cond_broadcast(&par->cond);
+    }
+    pthread_mutex_unlock(&par->lock);
+    return NULL;
+}
+
+// p是否为可以作为分块起点的行：位于行首、未超长、以[开头并能找到]的节行。
+// 这样的行总会重置节名和多行状态，从它开始解析与串行解析的结果相同
+static int ini_is_section_start(char* p, char* end)
+{
+    char* nl;
+    char* line_end;
+    char* close;
+
+    if (*p != '[' || ini_in_set(INI_START_COMMENT_PREFIXES, '['))
+        return 0;
+    nl = (char*)memchr(p, '\n', (size_t)(end - p));
+    line_end = nl ? nl : end;
+    if ((size_t)(line_end - p) + (nl ? 1 : 0) > INI_MAX_LINE - 1)
+        return 0;
+    line_end = ini_rstrip(p, line_end);
+    close = ini_find_chars_or_comment(p + 1, line_end, "]");
+    return close < line_end && *close == ']';
+}
+
+// 返回[p, end)中第一个可作为分块起点的行首，找不到时返回end。scanned记录已经扫描到的位置，
+// 保证多次调用的总扫描量是O(length)
+static char* ini_next_chunk_start(char* buf, char* p, char* end, char** scanned)
+{
+    char* nl;
+
+    if (p < *scanned)
+        p = *scanned;
+    // 先对齐到行首
+    if (p > buf && p < end && p[-1] != '\n')
+    {
+        nl = (char*)memchr(p, '\n', (size_t)(end - p));
+        p = nl ? nl + 1 : end;
+    }
+    while (p < end && !ini_is_section_start(p, end))
+    {
+        nl = (char*)memchr(p, '\n', (size_t)(end - p));
+        p = nl ? nl + 1 : end;
+    }
+    *scanned = p < end ? p + 1 : end;
+    return p;
+}
+
+static int ini_parse_parallel_state(char* buf, size_t length, int threads, int writable,
+                                    ini_handler handler, ini_handler_ex handler_ex, void* user)
+{
+    ini_parallel par;
+    ini_parse_state rs;
+    ini_chunk* c;
+    ini_record* r;
+    pthread_t* workers;
+    size_t nworkers = 0;
+    size_t max_chunks;
+    size_t i;
+    size_t k;
+    char* end = buf + length;
+    char* p;
+    char* scanned = buf;
+    int base = 0;
+
+    if (threads <= 0)
+    {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? (int)n : 1;
+    }
+    if (threads < 2 || length < 2 * (size_t)INI_PARALLEL_CHUNK)
+        return ini_parse_whole_buffer(handler, handler_ex, user, buf, length, writable);
+
+    // 按目标大小切分，每个切点向后移到第一个合法的[section]行
+    max_chunks = length / INI_PARALLEL_CHUNK + 1;
+    par.chunks = (ini_chunk*)ini_malloc(max_chunks * sizeof(ini_chunk));
+    workers = (pthread_t*)ini_malloc((size_t)threads * sizeof(pthread_t));
+    if (!par.chunks || !workers)
+    {
+        ini_free(par.chunks);
+        ini_free(workers);
+        return -2;
+    }
+    par.nchunks = 0;
+    p = buf;
+    while (p < end)
+    {
+        c = &par.chunks[par.nchunks ++ ];
+        c->begin = p;
+        if ((size_t)(end - p) > INI_PARALLEL_CHUNK)
+            p = ini_next_chunk_start(buf, p + INI_PARALLEL_CHUNK, end, &scanned);
+        else
+            p = end;
+        c->length = (size_t)(p - c->begin);
+        c->records = NULL;
+        c->count = c->capacity = 0;
+        c->pool = NULL;
+        c->oom = 0;
+        c->done = 0;
+    }
+
+    par.writable = writable;
+    par.terminate = handler_ex == NULL;
+    par.next = 0;
+    par.replayed = 0;
+    par.window = (size_t)threads * 2;
+    par.stop = 0;
+    pthread_mutex_init(&par.lock, NULL);
+    pthread_cond_init(&par.cond, NULL);
+
+    for (i = 0; i < (size_t)threads && i < par.nchunks; i++)
+    {
+        if (pthread_create(&workers[nworkers], NULL, ini_parallel_worker, &par) == 0)
+            nworkers ++ ;
+    }
+
+    // 主线程按原始顺序回放各分块，行号和偏移换算回整个缓冲区
+    ini_state_init(&rs, handler, handler_ex, user);
+    for (k = 0; k < par.nchunks && !par.stop; k++)
+    {
+        c = &par.chunks[k];
+        pthread_mutex_lock(&par.lock);
+        if (par.next == k)
+        {
+            // 还没有工作线程领取（或线程创建失败），主线程自己解析
+            par.next ++ ;
+            pthread_mutex_unlock(&par.lock);
+            ini_chunk_parse(&par, c);
+            pthread_mutex_lock(&par.lock);
+            c->done = 1;
+        }
+        while (!c->done)
+            pthread_cond_wait(&par.cond, &par.lock);
+        pthread_mutex_unlock(&par.lock);
+
+        // 工作线程在锁内读取stop，写入也必须持锁
+        if (c->oom)
+        {
+            rs.error = -2;
+            pthread_mutex_lock(&par.lock);
+            par.stop = 1;
+            pthread_mutex_unlock(&par.lock);
+        }
+        for (i = 0; i < c->count && !par.stop; i++)
+        {
+            r = &c->records[i];
+            // 分块内的语法错误行早于当前条目时，先记下它，保持“首个错误行”的语义
+            if (!rs.error && c->fs.st.error && r->lineno >= c->fs.st.error)
+                rs.error = base + c->fs.st.error;
+            rs.section = r->section;
+            rs.section_len = r->section_len;
+            rs.lineno = base + r->lineno;
+            rs.offset = (size_t)(c->begin - buf) + r->offset;
+            if (!ini_call_handler(&rs, r->name, r->name_len, r->value, r->value_len) && !rs.error)
+            {
+                rs.error = rs.lineno;
+#if INI_STOP_ON_FIRST_ERROR
+                pthread_mutex_lock(&par.lock);
+                par.stop = 1;
+                pthread_mutex_unlock(&par.lock);
+#endif
+            }
+        }
+        if (!rs.error && c->fs.st.error)
+            rs.error = base + c->fs.st.error;
+        base += c->fs.st.lineno;
+        ini_chunk_release(c);
+
+        pthread_mutex_lock(&par.lock);
+        par.replayed ++ ;
+#if INI_STOP_ON_FIRST_ERROR
+        if (rs.error)
+            par.stop = 1;
+#endif
+        pthread_cond_broadcast(&par.cond);
+        pthread_mutex_unlock(&par.lock);
+    }
+
+    pthread_mutex_lock(&par.lock);
+    par.stop = 1;
+    pthread_cond_broadcast(&par.cond);
+    pthread_mutex_unlock(&par.lock);
+    for (i = 0; i < nworkers; i++)
+        pthread_join(workers[i], NULL);
+    for (k = 0; k < par.nchunks; k++)
+        ini_chunk_release(&par.chunks[k]);
+
+    pthread_cond_destroy(&par.cond);
+    pthread_mutex_destroy(&par.lock);
+    ini_free(workers);
+    ini_free(par.chunks);
+    return rs.error;
+}
+#endif /* INI_USE_THREADS */
+
+// ini_parse_file/ini_parse_file_ex的实现：每次fread一整块，块内用memchr切分行，
+// 避免fgets逐行加锁和拷贝
+static int ini_parse_file_state(FILE* file, ini_parser* fs)
+{
+    char* block;
+    size_t n;
+
+    block = (char*)ini_malloc(INI_BLOCK_SIZE);
+    if (!block)
+        return -2;
+
+    ini_feed_init(fs);
+    while ((n = fread(block, 1, INI_BLOCK_SIZE, file)) > 0)
+    {
+        if (ini_feed(fs, block, n, 1))
+        {
+            ini_free(block);
+            return fs->st.error;
+        }
+    }
+    ini_free(block);
+    return ini_feed_finish(fs);
+}
+
+// ini_parse_stream/ini_parse_stream_ex的实现：通过reader逐行读入行缓冲区后解析
+static int ini_parse_stream_state(ini_reader reader, void* stream, ini_parse_state* st)
 {
     // 是否使用栈
 #if INI_USE_STACK
@@ -113,20 +1082,8 @@ int ini_parse_stream(ini_reader reader, void* stream, ini_handler handler,
     char* new_line;
 #endif
 
-    char section[MAX_SECTION] = "";
-
-    // 是否允许多行值解析
-#if INI_ALLOW_MULTILINE
-    char prev_name[MAX_NAME] = "";
-#endif
-
     size_t offset;
-    char* start;
-    char* end;
-    char* name;
-    char* value;
-    int lineno = 0;
-    int error = 0;
+    size_t consumed = 0;
     char abyss[16];  /* Used to consume input when a line is too long. */
 
 #if !INI_USE_STACK
@@ -137,14 +1094,6 @@ int ini_parse_stream(ini_reader reader, void* stream, ini_handler handler,
     }
 #endif
 
-    // 回调函数原型
-#if INI_HANDLER_LINENO
-#define HANDLER(u, s, n, v) handler(u, s, n, v, lineno)
-#else
-#define HANDLER(u, s, n, v) handler(u, s, n, v)
-#endif
-
-
     while (reader(line, (int)max_line, stream) != NULL) 
     {
         offset = strlen(line);
@@ -171,117 +1120,28 @@ int ini_parse_stream(ini_reader reader, void* stream, ini_handler handler,
         }
 #endif
 
-        lineno ++ ;
+        st->lineno ++ ;
+        st->offset = consumed;
+        consumed += offset;
 
         // 如果行超过INI_MAX_line字节，则丢弃，直到行结束
         if (offset == max_line - 1 && line[offset - 1] != '\n') 
         {
             while (reader(abyss, sizeof(abyss), stream) != NULL) 
             {
-                if (!error)
-                    error = lineno;
+                if (!st->error)
+                    st->error = st->lineno;
+                consumed += strlen(abyss);
                 if (abyss[strlen(abyss) - 1] == '\n')
                     break;
             }
         }
 
-        start = line;
-#if INI_ALLOW_BOM
-        if (lineno == 1 && (unsigned char)start[0] == 0xEF &&
-                           (unsigned char)start[1] == 0xBB &&
-                           (unsigned char)start[2] == 0xBF)
-        {
-            start += 3;
-        }
-#endif
-        start = ini_rstrip(ini_lskip(start));
-
-        if (strchr(INI_START_COMMENT_PREFIXES, *start)) 
-        {
-            // 行首注释
-        }
-
-#if INI_ALLOW_MULTILINE
-        else if (*prev_name && *start && start > line) 
-        {
-            // 若上一行解析的键为prev_name且当前行以空白开头，则将当前行内容追加到上一行的值。
-            // 如果start指针与原line指针不同，则说明行首存在空白字符
-#if INI_ALLOW_INLINE_COMMENTS
-            end = ini_find_chars_or_comment(start, NULL);
-            if (*end)
-                *end = '\0';
-            ini_rstrip(start);
-#endif
-            // 带有前导空格的非空行，视为续行
-            if (!HANDLER(user, section, prev_name, start) && !error)
-                error = lineno;
-        }
-#endif
-        else if (*start == '[') 
-        {
-            // 找到新的一section
-            end = ini_find_chars_or_comment(start + 1, "]");
-            if (*end == ']') 
-            {
-                *end = '\0';
-                ini_strncpy0(section, start + 1, sizeof(section));
-#if INI_ALLOW_MULTILINE
-                *prev_name = '\0';
-#endif
-#if INI_CALL_HANDLER_ON_NEW_SECTION
-                if (!HANDLER(user, section, NULL, NULL) && !error)
-                    error = lineno;
-#endif
-            }
-            else if (!error) 
-            {
-                // 这个新的section没有以]结尾
-                error = lineno;
-            }
-        }
-        else if (*start) 
-        {
-            // 不是注释的话，必须是name=value或者name:value
-            end = ini_find_chars_or_comment(start, "=:");
-            if (*end == '=' || *end == ':') 
-            {
-                *end = '\0';
-                name = ini_rstrip(start);
-                value = end + 1;
-#if INI_ALLOW_INLINE_COMMENTS
-                end = ini_find_chars_or_comment(value, NULL);
-                if (*end)
-                    *end = '\0';
-#endif
-                value = ini_lskip(value);
-                ini_rstrip(value);
-
-#if INI_ALLOW_MULTILINE
-                ini_strncpy0(prev_name, name, sizeof(prev_name));
-#endif
-                // 调用回调
-                if (!HANDLER(user, section, name, value) && !error)
-                    error = lineno;
-            }
-            else 
-            {
-                /// 没有找到=或者:
-                // 是否允许无值键，不允许则视为错误
-#if INI_ALLOW_NO_VALUE
-                *end = '\0';
-                name = ini_rstrip(start);
-                if (!HANDLER(user, section, name, NULL) && !error)
-                    error = lineno;
-#else
-                if (!error)
-                    error = lineno;
-#endif
-            }
-        }
+        ini_parse_line(st, line, offset);
 
         // 是否在遇到首个错误时停止解析
 #if INI_STOP_ON_FIRST_ERROR
-        if (error)
+        if (st->error)
             break;
 #endif
     }
@@ -290,17 +1150,10 @@ int ini_parse_stream(ini_reader reader, void* stream, ini_handler handler,
     ini_free(line);
 #endif
 
-    return error;
+    return st->error;
 }
 
-
-int ini_parse_file(FILE* file, ini_handler handler, void* user)
-{
-    return ini_parse_stream((ini_reader)fgets, file, handler, user);
-}
-
-
-int ini_parse(const char* filename, ini_handler handler, void* user)
+static int ini_parse_filename_state(const char* filename, ini_parser* fs)
 {
     FILE* file;
     int error;
@@ -312,37 +1165,89 @@ int ini_parse(const char* filename, ini_handler handler, void* user)
         perror(filename);
         return -1;
     }
-    error = ini_parse_file(file, handler, user);
+    error = ini_parse_file_state(file, fs);
     fclose(file);
     return error;
 }
 
-// 用于从字符串缓冲区读取下一行。这是ini_parse_string（）使用的fgets（）等效函数
-static char* ini_reader_string(char* str, int num, void* stream) 
+static int ini_parse_mmap_state(const char* filename, ini_parser* fs)
 {
-    ini_parse_string_ctx* ctx = (ini_parse_string_ctx*)stream;
-    const char* ctx_ptr = ctx->ptr;
-    size_t ctx_num_left = ctx->num_left;
-    char* strp = str;
-    char c;
-
-    if (ctx_num_left == 0 || num < 2)
-        return NULL;
+#if INI_USE_MMAP
+    struct stat sb;
+    char* map;
+    int fd;
+    int error;
 
-    while (num > 1 && ctx_num_left != 0) 
+    fd = open(filename, O_RDONLY);
+    if (fd < 0)
     {
-        c = *ctx_ptr ++ ;
-        ctx_num_left -- ;
-        *strp ++ = c;
-        if (c == '\n')
-            break;
-        num -- ;
+        perror(filename);
+        return -1;
     }
+    if (fstat(fd, &sb) != 0 || (uint64_t)sb.st_size > SIZE_MAX)
+    {
+        close(fd);
+        return -1;
+    }
+    if (sb.st_size == 0)
+    {
+        close(fd);
+        return 0;
+    }
+
+    // 需要写入NUL结束符时使用PROT_WRITE + MAP_PRIVATE：写入只触发写时复制，不会回写到文件。
+    // ini_handler_ex不写入映射，只读映射即可，不会产生任何页拷贝
+    map = (char*)mmap(NULL, (size_t)sb.st_size,
+                      fs->st.terminate ? PROT_READ | PROT_WRITE : PROT_READ,
+                      MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return -2;
+    madvise(map, (size_t)sb.st_size, MADV_SEQUENTIAL);
+
+    error = ini_parse_buffer(fs, map, (size_t)sb.st_size, fs->st.terminate);
+
+    munmap(map, (size_t)sb.st_size);
+    return error;
+#else
+    return ini_parse_filename_state(filename, fs);
+#endif
+}
+
+int ini_parse_stream(ini_reader reader, void* stream, ini_handler handler,
+                     void* user)
+{
+    ini_parse_state st;
+
+    ini_state_init(&st, handler, NULL, user);
+    return ini_parse_stream_state(reader, stream, &st);
+}
+
+
+int ini_parse_file(FILE* file, ini_handler handler, void* user)
+{
+    ini_parser fs;
+
+    ini_state_init(&fs.st, handler, NULL, user);
+    return ini_parse_file_state(file, &fs);
+}
+
+
+int ini_parse(const char* filename, ini_handler handler, void* user)
+{
+    ini_parser fs;
 
-    *strp = '\0';
-    ctx->ptr = ctx_ptr;
-    ctx->num_left = ctx_num_left;
-    return str;
+    ini_state_init(&fs.st, handler, NULL, user);
+    return ini_parse_filename_state(filename, &fs);
+}
+
+
+int ini_parse_mmap(const char* filename, ini_handler handler, void* user)
+{
+    ini_parser fs;
+
+    ini_state_init(&fs.st, handler, NULL, user);
+    return ini_parse_mmap_state(filename, &fs);
 }
 
 int ini_parse_string(const char* string, ini_handler handler, void* user) 
@@ -352,9 +1257,119 @@ int ini_parse_string(const char* string, ini_handler handler, void* user)
 
 int ini_parse_string_length(const char* string, size_t length, ini_handler handler, void* user) 
 {
-    ini_parse_string_ctx ctx;
+    ini_parser fs;
+
+    // 输入不可写：每行用memchr定位后整行拷贝一次，再写入NUL结束符
+    ini_state_init(&fs.st, handler, NULL, user);
+    return ini_parse_buffer(&fs, (char*)string, length, 0);
+}
+
+int ini_parse_string_inplace(char* string, size_t length, ini_handler handler, void* user)
+{
+    ini_parser fs;
+
+    ini_state_init(&fs.st, handler, NULL, user);
+    return ini_parse_buffer(&fs, string, length, 1);
+}
+
+
+int ini_parse_stream_ex(ini_reader reader, void* stream, ini_handler_ex handler,
+                        void* user)
+{
+    ini_parse_state st;
+
+    ini_state_init(&st, NULL, handler, user);
+    return ini_parse_stream_state(reader, stream, &st);
+}
+
+int ini_parse_file_ex(FILE* file, ini_handler_ex handler, void* user)
+{
+    ini_parser fs;
+
+    ini_state_init(&fs.st, NULL, handler, user);
+    return ini_parse_file_state(file, &fs);
+}
+
+int ini_parse_ex(const char* filename, ini_handler_ex handler, void* user)
+{
+    ini_parser fs;
 
-    ctx.ptr = string;
-    ctx.num_left = length;
-    return ini_parse_stream((ini_reader)ini_reader_string, &ctx, handler, user);
+    ini_state_init(&fs.st, NULL, handler, user);
+    return ini_parse_filename_state(filename, &fs);
+}
+
+int ini_parse_mmap_ex(const char* filename, ini_handler_ex handler, void* user)
+{
+    ini_parser fs;
+
+    ini_state_init(&fs.st, NULL, handler, user);
+    return ini_parse_mmap_state(filename, &fs);
+}
+
+int ini_parse_string_ex(const char* string, ini_handler_ex handler, void* user)
+{
+    return ini_parse_string_length_ex(string, strlen(string), handler, user);
+}
+
+int ini_parse_string_length_ex(const char* string, size_t length, ini_handler_ex handler, void* user)
+{
+    ini_parser fs;
+
+    // ini_handler_ex不需要NUL结束符，直接在调用者的缓冲区上解析，不做任何拷贝
+    ini_state_init(&fs.st, NULL, handler, user);
+    return ini_parse_buffer(&fs, (char*)string, length, 0);
+}
+
+int ini_parse_parallel(char* buffer, size_t length, int threads, ini_handler handler, void* user)
+{
+#if INI_USE_THREADS
+    return ini_parse_parallel_state(buffer, length, threads, 1, handler, NULL, user);
+#else
+    (void)threads;
+    return ini_parse_whole_buffer(handler, NULL, user, buffer, length, 1);
+#endif
+}
+
+int ini_parse_parallel_ex(const char* buffer, size_t length, int threads,
+                          ini_handler_ex handler, void* user)
+{
+#if INI_USE_THREADS
+    return ini_parse_parallel_state((char*)buffer, length, threads, 0, NULL, handler, user);
+#else
+    (void)threads;
+    return ini_parse_whole_buffer(NULL, handler, user, (char*)buffer, length, 0);
+#endif
+}
+
+void ini_parser_init(ini_parser* parser, ini_handler handler, void* user)
+{
+    ini_state_init(&parser->st, handler, NULL, user);
+    ini_feed_init(parser);
+}
+
+void ini_parser_init_ex(ini_parser* parser, ini_handler_ex handler, void* user)
+{
+    ini_state_init(&parser->st, NULL, handler, user);
+    ini_feed_init(parser);
+}
+
+int ini_parser_feed(ini_parser* parser, const char* bytes, size_t n)
+{
+#if INI_STOP_ON_FIRST_ERROR
+    if (parser->st.error)
+        return parser->st.error;
+#endif
+    // 调用者的数据只读且调用返回后即失效：完整的行直接在bytes上解析（ini_handler需先拷贝一次），
+    // 不完整的行拷贝到partial中，节名和键名总是保存到解析器内部
+    ini_feed(parser, (char*)bytes, n, 0);
+    return parser->st.error;
+}
+
+int ini_parser_finish(ini_parser* parser)
+{
+#if INI_STOP_ON_FIRST_ERROR
+    if (parser->st.error)
+        return parser->st.error;
+#endif
+    return ini_feed_finish(parser);
 }
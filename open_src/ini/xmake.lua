@@ -1,5 +1,8 @@
 target("ini")
     set_kind("shared")
-    add_files("ini.c", "INIReader.cpp")
+    add_files("ini.c", "INIReader.cpp", "INICache.cpp", "ConfigSnapshot.cpp", "INILayeredReader.cpp")
     add_includedirs("../../include")
-    add_cxflags("-g")
\ No newline at end of file
+    add_cxflags("-g")
+    if is_plat("linux") then
+        add_syslinks("pthread")
+    end